@@ -76,6 +76,11 @@ struct channel {
 	struct disk devices[2];     /* The devices on this channel. */
 };
 
+/* How long disk_read() waits for the channel and for the disk,
+   in timer ticks.  Matches the 30 seconds wait_while_busy()
+   allows. */
+#define DISK_TIMEOUT (30 * TIMER_FREQ)
+
 /* We support the two "legacy" ATA channels found in a standard PC. */
 #define CHANNEL_CNT 2
 static struct channel channels[CHANNEL_CNT];
@@ -209,21 +214,52 @@ disk_size (struct disk *d) {
    per-disk locking is unneeded. */
 void
 disk_read (struct disk *d, disk_sector_t sec_no, void *buffer) {
+	if (!disk_read_timeout (d, sec_no, buffer, DISK_TIMEOUT))
+		PANIC ("%s: disk read timed out, sector=%"PRDSNu, d->name, sec_no);
+}
+
+/* Like disk_read(), but gives up and returns false if the
+   channel does not become free within TICKS timer ticks, or if
+   the disk does not complete the read within TICKS more.  After
+   a timed-out read the channel is reset, so that the abandoned
+   command cannot confuse the next one. */
+bool
+disk_read_timeout (struct disk *d, disk_sector_t sec_no, void *buffer,
+		int64_t ticks) {
 	struct channel *c;
+	enum intr_level old_level;
+	bool completed;
 
 	ASSERT (d != NULL);
 	ASSERT (buffer != NULL);
 
 	c = d->channel;
-	lock_acquire (&c->lock);
+	if (!lock_acquire_timeout (&c->lock, ticks))
+		return false;
 	select_sector (d, sec_no);
 	issue_pio_command (c, CMD_READ_SECTOR_RETRY);
-	sema_down (&c->completion_wait);
+	completed = sema_down_timeout (&c->completion_wait, ticks);
+	if (!completed) {
+		/* The interrupt may still be on its way.  Stop expecting
+		   it, and take it if it made it in the meantime. */
+		old_level = intr_disable ();
+		c->expecting_interrupt = false;
+		completed = sema_try_down (&c->completion_wait);
+		intr_set_level (old_level);
+	}
+	if (!completed) {
+		printf ("%s: read timed out, sector=%"PRDSNu", resetting\n",
+				d->name, sec_no);
+		reset_channel (c);
+		lock_release (&c->lock);
+		return false;
+	}
 	if (!wait_while_busy (d))
 		PANIC ("%s: disk read failed, sector=%"PRDSNu, d->name, sec_no);
 	input_sector (c, buffer);
 	d->read_cnt++;
 	lock_release (&c->lock);
+	return true;
 }
 
 /* Write sector SEC_NO to disk D from BUFFER, which must contain
@@ -1,12 +1,17 @@
 #include "devices/timer.h"
 #include <debug.h>
+#include <heap.h>
 #include <inttypes.h>
 #include <round.h>
 #include <stdio.h>
 #include "threads/interrupt.h"
 #include "threads/io.h"
+#include "threads/profile.h"
+#include "threads/smp.h"
 #include "threads/synch.h"
 #include "threads/thread.h"
+#include "threads/workqueue.h"
+#include "intrinsic.h"
 // #include "threads/thread.c"
 
 /* See [8254] for hardware details of the 8254 timer chip. */
@@ -18,57 +23,205 @@
 #error TIMER_FREQ <= 1000 recommended
 #endif
 
+/* 8254 input frequency, in Hz. */
+#define PIT_HZ 1193180
+
+/* PIT counts per timer tick, rounded to nearest. */
+#define PIT_COUNT ((PIT_HZ + TIMER_FREQ / 2) / TIMER_FREQ)
+
 /* Number of timer ticks since OS booted. */
 static int64_t ticks;
 
-/* Number of loops per timer tick.
-   Initialized by timer_calibrate(). */
-static unsigned loops_per_tick;
+/* Number of timer interrupts taken since OS booted.  Equal to
+   TICKS unless dynamic ticks are enabled. */
+static int64_t interrupts;
+
+/* If false (default), the timer interrupts TIMER_FREQ times per
+   second.  If true, the idle thread reprograms the PIT to fire
+   once, at the next deadline, instead of every tick.
+   Controlled by kernel command-line option "-tickless". */
+bool timer_tickless;
+
+/* Ticks covered by the armed one-shot, or 0 if the PIT is in
+   periodic mode. */
+static int64_t oneshot_ticks;
+
+/* TSC frequency, in cycles per second, and the TSC value at
+   timer_init(), which timer_clock_ns() counts from.  TSC_HZ is
+   measured by timer_calibrate(). */
+static uint64_t tsc_hz;
+static uint64_t boot_tsc;
+
+/* Ticks over which timer_calibrate() measures the TSC. */
+#define CALIBRATE_TICKS 5
+
+/* Intervals shorter than this are below what the PIT can time
+   (one count is about 838 ns), so timer_nsleep() spins on the
+   TSC for them instead of blocking. */
+#define SPIN_NS 2000
+
+/* A thread sleeping until a deadline in nanoseconds.  Lives on
+   the sleeping thread's stack. */
+struct hrtimer {
+	struct heap_elem elem;      /* Element in hrtimer_heap. */
+	int64_t expires;            /* Deadline, per timer_clock_ns(). */
+	struct thread *thread;      /* Thread to wake. */
+};
+
+/* Armed hrtimers, soonest deadline first.  The timer interrupt
+   reaches the heap, so like the sleep queue it is guarded by a
+   spinlock. */
+static struct heap hrtimer_heap;
+static struct spinlock hrtimer_lock;
+
+/* If nonzero, the PIT is in one-shot mode for an hrtimer
+   deadline that falls inside the current tick, and the tick
+   itself is due this many PIT counts after that interrupt. */
+static unsigned hr_rest;
+
+/* True while the PIT is in one-shot mode for the remainder of a
+   tick that an hrtimer interrupt split. */
+static bool tick_rest;
 
 static intr_handler_func timer_interrupt;
-static bool too_many_loops (unsigned loops);
-static void busy_wait (int64_t loops);
-static void real_time_sleep (int64_t num, int32_t denom);
+static void pit_set_periodic (void);
+static void pit_set_oneshot (unsigned count);
+static void hrtimer_expire (void);
+static void hrtimer_program (void);
+static heap_less_func hrtimer_less;
 // static void timer_interrupt (struct intr_frame *args UNUSED);
 /* Sets up the 8254 Programmable Interval Timer (PIT) to
    interrupt PIT_FREQ times per second, and registers the
    corresponding interrupt. */
 void
 timer_init (void) {
+	boot_tsc = rdtsc ();
+	heap_init (&hrtimer_heap, hrtimer_less, NULL);
+	spinlock_init (&hrtimer_lock);
+	pit_set_periodic ();
+	intr_register_ext (0x20, timer_interrupt, "8254 Timer");
+}
+
+/* Programs the PIT to interrupt TIMER_FREQ times per second. */
+static void
+pit_set_periodic (void) {
 	/* 8254 input frequency divided by TIMER_FREQ, rounded to
 	   nearest. */
-	uint16_t count = (1193180 + TIMER_FREQ / 2) / TIMER_FREQ;
+	uint16_t count = PIT_COUNT;
 
 	outb (0x43, 0x34);    /* CW: counter 0, LSB then MSB, mode 2, binary. */
 	outb (0x40, count & 0xff);
 	outb (0x40, count >> 8);
+}
 
-	intr_register_ext (0x20, timer_interrupt, "8254 Timer");
+/* Programs the PIT to interrupt once, COUNT PIT counts from now. */
+static void
+pit_set_oneshot (unsigned count) {
+	ASSERT (count > 0 && count <= UINT16_MAX);
+
+	outb (0x43, 0x30);    /* CW: counter 0, LSB then MSB, mode 0, binary. */
+	outb (0x40, count & 0xff);
+	outb (0x40, count >> 8);
+}
+
+/* Returns the current value of PIT counter 0. */
+static uint16_t
+pit_read_count (void) {
+	uint8_t lo, hi;
+
+	outb (0x43, 0x00);    /* CW: counter 0, latch count. */
+	lo = inb (0x40);
+	hi = inb (0x40);
+	return lo | (hi << 8);
+}
+
+/* Called by the idle thread, with interrupts off, just before it
+   halts.  With dynamic ticks enabled, programs the PIT to
+   interrupt once, at the next time anything needs the timer:
+   the earliest sleeping thread's wakeup or delayed work item, or
+   under the 4.4BSD scheduler the next once-a-second update.  The 16-bit counter
+   limits how far ahead that can be.  With more than one CPU up,
+   another CPU may queue an earlier deadline while this one
+   halts, so the timer stays periodic. */
+void
+timer_idle_enter (void) {
+	int64_t max_ticks = UINT16_MAX / PIT_COUNT;
+	int64_t n;
+	bool armed;
+
+	ASSERT (intr_get_level () == INTR_OFF);
+	if (!timer_tickless || cpu_cnt > 1)
+		return;
+
+	/* A pending hrtimer keeps the PIT busy splitting ticks. */
+	spinlock_acquire (&hrtimer_lock);
+	armed = !heap_empty (&hrtimer_heap) || hr_rest > 0 || tick_rest;
+	spinlock_release (&hrtimer_lock);
+	if (armed)
+		return;
+
+	n = get_next_tick_to_awake () - ticks;
+	if (workqueue_next_deadline () - ticks < n)
+		n = workqueue_next_deadline () - ticks;
+	if (thread_mlfqs && n > TIMER_FREQ - ticks % TIMER_FREQ)
+		n = TIMER_FREQ - ticks % TIMER_FREQ;
+	if (n > max_ticks)
+		n = max_ticks;
+	if (n <= 1)
+		return;
+
+	pit_set_oneshot (n * PIT_COUNT);
+	oneshot_ticks = n;
+}
+
+/* Called by the idle thread when it stops halting.  If some
+   other interrupt woke the CPU before the one-shot fired,
+   accounts for the whole ticks that have passed and goes back to
+   periodic mode, losing the partial tick in progress. */
+void
+timer_idle_exit (void) {
+	enum intr_level old_level = intr_disable ();
+
+	if (oneshot_ticks > 0) {
+		int64_t elapsed = (oneshot_ticks * PIT_COUNT - pit_read_count ())
+			/ PIT_COUNT;
+
+		/* The one-shot was armed no further ahead than the next
+		   deadline, so nothing falls due in ELAPSED.  If it
+		   expired just now, its interrupt is still pending and
+		   will account for the final tick. */
+		if (elapsed < 0 || elapsed >= oneshot_ticks)
+			elapsed = oneshot_ticks - 1;
+		ticks += elapsed;
+		thread_idle_ticks (cpu_id (), elapsed);
+		oneshot_ticks = 0;
+		pit_set_periodic ();
+	}
+	intr_set_level (old_level);
 }
 
-/* Calibrates loops_per_tick, used to implement brief delays. */
+/* Measures the TSC frequency against the timer interrupt, for
+   timer_clock_ns(). */
 void
 timer_calibrate (void) {
-	unsigned high_bit, test_bit;
+	int64_t start;
+	uint64_t start_tsc;
 
 	ASSERT (intr_get_level () == INTR_ON);
 	printf ("Calibrating timer...  ");
 
-	/* Approximate loops_per_tick as the largest power-of-two
-	   still less than one timer tick. */
-	loops_per_tick = 1u << 10;
-	while (!too_many_loops (loops_per_tick << 1)) {
-		loops_per_tick <<= 1;
-		ASSERT (loops_per_tick != 0);
-	}
-
-	/* Refine the next 8 bits of loops_per_tick. */
-	high_bit = loops_per_tick;
-	for (test_bit = high_bit >> 1; test_bit != high_bit >> 10; test_bit >>= 1)
-		if (!too_many_loops (high_bit | test_bit))
-			loops_per_tick |= test_bit;
+	/* Start on a tick boundary, then count TSC cycles across
+	   CALIBRATE_TICKS whole ticks. */
+	start = ticks;
+	while (ticks == start)
+		barrier ();
+	start = ticks;
+	start_tsc = rdtsc ();
+	while (ticks - start < CALIBRATE_TICKS)
+		barrier ();
+	tsc_hz = (rdtsc () - start_tsc) * TIMER_FREQ / CALIBRATE_TICKS;
 
-	printf ("%'"PRIu64" loops/s.\n", (uint64_t) loops_per_tick * TIMER_FREQ);
+	printf ("%'"PRIu64" TSC cycles/s.\n", tsc_hz);
 }
 
 /* Returns the number of timer ticks since the OS booted. */
@@ -101,95 +254,206 @@ timer_sleep (int64_t ticks) {	// test case 인자 : 재울 시간
 }
 
 
+/* Returns the number of nanoseconds since timer_init(), read
+   from the TSC.  The clock is monotonic and does not depend on
+   the timer interrupt, so it keeps counting while interrupts are
+   off.  Until timer_calibrate() has run, it only has tick
+   resolution. */
+int64_t
+timer_clock_ns (void) {
+	uint64_t cycles = rdtsc () - boot_tsc;
+
+	if (tsc_hz == 0)
+		return timer_ticks () * (NSEC_PER_SEC / TIMER_FREQ);
+	return cycles / tsc_hz * NSEC_PER_SEC
+		+ cycles % tsc_hz * NSEC_PER_SEC / tsc_hz;
+}
+
+/* Blocks the current thread until timer_clock_ns() reaches
+   DEADLINE.  If the deadline falls before the next tick, the PIT
+   is reprogrammed to interrupt at the deadline, so the thread
+   wakes with sub-tick precision. */
+void
+timer_sleep_until_ns (int64_t deadline) {
+	struct hrtimer timer;
+	enum intr_level old_level;
+
+	ASSERT (!intr_context ());
+	ASSERT (intr_get_level () == INTR_ON);
+
+	old_level = intr_disable ();
+	if (deadline > timer_clock_ns ()) {
+		timer.expires = deadline;
+		timer.thread = thread_current ();
+		spinlock_acquire (&hrtimer_lock);
+		heap_insert (&hrtimer_heap, &timer.elem);
+		hrtimer_program ();
+		spinlock_release (&hrtimer_lock);
+		thread_block ();
+	}
+	intr_set_level (old_level);
+}
+
 /* Suspends execution for approximately MS milliseconds. */
 void
 timer_msleep (int64_t ms) {
-	real_time_sleep (ms, 1000);
+	timer_nsleep (ms * 1000 * 1000);
 }
 
 /* Suspends execution for approximately US microseconds. */
 void
 timer_usleep (int64_t us) {
-	real_time_sleep (us, 1000 * 1000);
+	timer_nsleep (us * 1000);
 }
 
-/* Suspends execution for approximately NS nanoseconds. */
+/* Suspends execution for approximately NS nanoseconds.  Blocks,
+   unless NS is too short for the PIT to time, in which case it
+   spins on the TSC. */
 void
 timer_nsleep (int64_t ns) {
-	real_time_sleep (ns, 1000 * 1000 * 1000);
+	int64_t start = timer_clock_ns ();
+
+	if (ns <= 0)
+		return;
+	if (ns < SPIN_NS) {
+		while (timer_clock_ns () - start < ns)
+			barrier ();
+		return;
+	}
+	timer_sleep_until_ns (start + ns);
+}
+
+/* Returns the number of timer interrupts taken since the OS
+   booted. */
+int64_t
+timer_interrupts (void) {
+	enum intr_level old_level = intr_disable ();
+	int64_t n = interrupts;
+	intr_set_level (old_level);
+	barrier ();
+	return n;
 }
 
 /* Prints timer statistics. */
 void
 timer_print_stats (void) {
 	printf ("Timer: %"PRId64" ticks\n", timer_ticks ());
+	if (timer_tickless)
+		printf ("Timer: %"PRId64" interrupts (dynamic ticks)\n",
+				timer_interrupts ());
 }
 
 /* Timer interrupt handler. */
 /* 타이머 인터럽트 핸들러 */
 static void
-timer_interrupt (struct intr_frame *args UNUSED) {
+timer_interrupt (struct intr_frame *args) {
+	interrupts++;
+	if (hr_rest > 0) {
+		/* An hrtimer's one-shot, not a tick.  Time the rest of the
+		   tick before anything else. */
+		pit_set_oneshot (hr_rest);
+		hr_rest = 0;
+		tick_rest = true;
+		hrtimer_expire ();
+		return;
+	}
+	if (tick_rest) {
+		tick_rest = false;
+		pit_set_periodic ();
+	}
+	if (oneshot_ticks > 0) {
+		/* The idle thread's one-shot fired: replay the ticks it
+		   skipped, then go back to periodic mode. */
+		for (; oneshot_ticks > 1; oneshot_ticks--) {
+			ticks++;
+			thread_tick ();
+		}
+		oneshot_ticks = 0;
+		pit_set_periodic ();
+	}
 	ticks++;	/* OS가 부팅된 이후 타이머 틱 수 */
 	thread_tick ();
+	if (profile_enabled)
+		profile_sample (args);
 	/* 매 tick마다 sleep queue에서 깨어날 thread가 있는지 확인하여, 깨우는 함수를 호출 */
 	if (ticks >= get_next_tick_to_awake()){
-		thread_awake(ticks); 
+		thread_awake(ticks);
 	}
+	thread_edf_release (ticks);
+	if (ticks >= workqueue_next_deadline ())
+		workqueue_tick (ticks);
+	hrtimer_expire ();
 }
 
-/* Returns true if LOOPS iterations waits for more than one timer
-   tick, otherwise false. */
-static bool
-too_many_loops (unsigned loops) {
-	/* Wait for a timer tick. */
-	int64_t start = ticks;
-	while (ticks == start)
-		barrier ();
-
-	/* Run LOOPS loops. */
-	start = ticks;
-	busy_wait (loops);
+/* Wakes the threads whose hrtimers have expired, then programs
+   the PIT for the next deadline.  Interrupts must be off. */
+static void
+hrtimer_expire (void) {
+	int64_t now = timer_clock_ns ();
 
-	/* If the tick count changed, we iterated too long. */
-	barrier ();
-	return start != ticks;
+	ASSERT (intr_get_level () == INTR_OFF);
+	spinlock_acquire (&hrtimer_lock);
+	while (!heap_empty (&hrtimer_heap)) {
+		struct hrtimer *timer = heap_entry (heap_top (&hrtimer_heap),
+				struct hrtimer, elem);
+		if (timer->expires > now)
+			break;
+		heap_pop (&hrtimer_heap);
+		thread_unblock (timer->thread);
+		if (intr_context () && runq_preempts (thread_current ()))
+			intr_yield_on_return ();
+	}
+	hrtimer_program ();
+	spinlock_release (&hrtimer_lock);
 }
 
-/* Iterates through a simple loop LOOPS times, for implementing
-   brief delays.
+/* If the earliest hrtimer expires before the next tick, switches
+   the PIT to a one-shot that interrupts at its deadline and
+   remembers how much of the tick is left after it.  Deadlines at
+   or past the next tick are left to the tick itself.
+   HRTIMER_LOCK must be held. */
+static void
+hrtimer_program (void) {
+	struct hrtimer *timer;
+	int64_t left;
+	unsigned rest, count;
 
-   Marked NO_INLINE because code alignment can significantly
-   affect timings, so that if this function was inlined
-   differently in different places the results would be difficult
-   to predict. */
-static void NO_INLINE
-busy_wait (int64_t loops) {
-	while (loops-- > 0)
-		barrier ();
-}
+	ASSERT (spinlock_held_by_current_thread (&hrtimer_lock));
+	if (heap_empty (&hrtimer_heap))
+		return;
 
-/* Sleep for approximately NUM/DENOM seconds. */
-static void
-real_time_sleep (int64_t num, int32_t denom) {
-	/* Convert NUM/DENOM seconds into timer ticks, rounding down.
+	/* The idle thread may have been preempted with a multi-tick
+	   one-shot armed; return to periodic mode first. */
+	if (oneshot_ticks > 0)
+		timer_idle_exit ();
 
-	   (NUM / DENOM) s
-	   ---------------------- = NUM * TIMER_FREQ / DENOM ticks.
-	   1 s / TIMER_FREQ ticks
-	   */
-	int64_t ticks = num * TIMER_FREQ / denom;
+	/* PIT counts until the next tick.  A one-shot that already
+	   ran out reads back as a wrapped count; its interrupt is
+	   pending and will reprogram the PIT. */
+	rest = pit_read_count ();
+	if (rest > PIT_COUNT)
+		return;
+	rest += hr_rest;
 
-	ASSERT (intr_get_level () == INTR_ON);
-	if (ticks > 0) {
-		/* We're waiting for at least one full timer tick.  Use
-		   timer_sleep() because it will yield the CPU to other
-		   processes. */
-		timer_sleep (ticks);
-	} else {
-		/* Otherwise, use a busy-wait loop for more accurate
-		   sub-tick timing.  We scale the numerator and denominator
-		   down by 1000 to avoid the possibility of overflow. */
-		ASSERT (denom % 1000 == 0);
-		busy_wait (loops_per_tick * num / 1000 * TIMER_FREQ / (denom / 1000));
-	}
+	timer = heap_entry (heap_top (&hrtimer_heap), struct hrtimer, elem);
+	left = timer->expires - timer_clock_ns ();
+	if (left >= NSEC_PER_SEC / TIMER_FREQ)
+		return;
+	count = left > 0 ? left * PIT_HZ / NSEC_PER_SEC : 0;
+	if (count == 0)
+		count = 1;
+	if (count >= rest)
+		return;
+
+	pit_set_oneshot (count);
+	hr_rest = rest - count;
+	tick_rest = false;
+}
+
+/* Orders hrtimers by deadline. */
+static bool
+hrtimer_less (const struct heap_elem *a, const struct heap_elem *b,
+		void *aux UNUSED) {
+	return heap_entry (a, struct hrtimer, elem)->expires
+		< heap_entry (b, struct hrtimer, elem)->expires;
 }
@@ -23,7 +23,7 @@ struct fat_fs {
 	unsigned int fat_length;
 	disk_sector_t data_start;
 	cluster_t last_clst;
-	struct lock write_lock;
+	struct lock write_lock;         /* Serializes chain allocation. */
 };
 
 static struct fat_fs *fat_fs;
@@ -158,8 +158,7 @@ fat_fs_init (void) {
 	fat_fs->data_start = fat_fs->bs.fat_start + fat_fs->bs.fat_sectors; // ##### 1
 	// fat_fs->last_clst = fat_fs->bs.fat_sectors / SECTORS_PER_CLUSTER;
 	// fat_fs->last_clst = fat_fs->bs.fat_start + fat_fs->bs.fat_sectors;
-	// lock_init(&fat_fs->write_lock);
-	
+	lock_init(&fat_fs->write_lock);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -177,20 +176,22 @@ fat_create_chain (cluster_t clst) {
 	// }
 	// return 0;
 	cluster_t i = 2;
+	lock_acquire(&fat_fs->write_lock);
 	while (fat_get(i) != 0 && i < fat_fs->fat_length) {
 		++i;
 	}
 	if (i == fat_fs->fat_length) {	// FAT가 가득 찼다면
+		lock_release(&fat_fs->write_lock);
 		return 0;
 	}
 	fat_put(i, EOChain);	// FAT안의 값 업데이트
-	if (clst == 0) {	// 새로운 체인 생성
-		return i;
-	}
-	while(fat_get(clst) != EOChain) {
-		clst = fat_get(clst);
+	if (clst != 0) {	// 기존 체인 끝에 연결
+		while(fat_get(clst) != EOChain) {
+			clst = fat_get(clst);
+		}
+		fat_put(clst, i);
 	}
-	fat_put(clst, i);
+	lock_release(&fat_fs->write_lock);
 	return i;
 }
 
@@ -205,6 +206,7 @@ fat_remove_chain (cluster_t clst, cluster_t pclst) {
 	// fat_put(clst-1, pclst);
 
 	cluster_t next;
+	lock_acquire(&fat_fs->write_lock);
 	while(fat_fs->fat[clst] != EOChain) {
 		next = fat_fs->fat[clst];
 		fat_fs->fat[clst] = 0;
@@ -212,6 +214,7 @@ fat_remove_chain (cluster_t clst, cluster_t pclst) {
 	}
 	if(pclst != 0)
 		fat_fs->fat[pclst] = EOChain;
+	lock_release(&fat_fs->write_lock);
 	
 	// /* pcluster가 입력됬으면 pcluster를 chain으로 끝으로 만듬 */
 	// if (pclst)
@@ -2,6 +2,8 @@
 #include <debug.h>
 #include "filesys/inode.h"
 #include "threads/malloc.h"
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
 
 
 
@@ -121,6 +123,36 @@ off_t file_write_at(struct file *file, const void *buffer, off_t size,
 	return inode_write_at(file->inode, buffer, size, file_ofs);
 }
 
+/* Copies SIZE bytes from FILE_IN, starting at offset IN_OFS, to
+ * FILE_OUT, starting at offset OUT_OFS, without going through
+ * user memory.  The data moves through a one-page kernel buffer,
+ * up to a page at a time; the chunks are not aligned to sectors
+ * unless IN_OFS and OUT_OFS are.
+ * Returns the number of bytes actually copied, which may be less
+ * than SIZE if end of FILE_IN is reached or an error occurs.
+ * Neither file's position is affected. */
+/* 유저 버퍼를 거치지 않고 커널 안에서 파일 사이에 복사 */
+off_t file_copy_range(struct file *file_in, off_t in_ofs,
+					  struct file *file_out, off_t out_ofs, off_t size){
+	uint8_t *buffer = palloc_get_page(0);
+	off_t bytes_copied = 0;
+
+	if (buffer == NULL)
+		return 0;
+	while (bytes_copied < size){
+		off_t chunk = size - bytes_copied < PGSIZE ? size - bytes_copied : PGSIZE;
+		off_t n = inode_read_at(file_in->inode, buffer, chunk,
+								in_ofs + bytes_copied);
+
+		n = inode_write_at(file_out->inode, buffer, n, out_ofs + bytes_copied);
+		bytes_copied += n;
+		if (n < chunk)
+			break;
+	}
+	palloc_free_page(buffer);
+	return bytes_copied;
+}
+
 /* Prevents write operations on FILE's underlying inode
  * until file_allow_write() is called or FILE is closed. */
 /* file_allow_write()를 호출하거나 FILE을 닫을 때까지 
@@ -57,9 +57,10 @@ void filesys_done(void)
 #endif
 }
 
-struct dir *parse_path(char *path_name, char *file_name)
+/* PATH_NAME 을 CWD 기준으로 해석해 마지막 요소가 들어 있는 디렉터리를 열어 반환하고
+   마지막 요소의 이름은 FILE_NAME 에 저장 */
+static struct dir *parse_path_at(struct dir *cwd, const char *path_name, char *file_name)
 {
-	struct thread *curr = thread_current();
 	struct dir *dir;
 	struct inode *inode;
 
@@ -75,7 +76,7 @@ struct dir *parse_path(char *path_name, char *file_name)
 	if (path[0] == '/')
 		dir = dir_open_root();
 	else
-		dir = dir_reopen(curr->cur_dir);
+		dir = dir_reopen(cwd);
 
 	/* PATH_NAME의 절대/상대경로에 따른 디렉터리 정보 저장 (구현)*/
 	char *token, *nextToken, *savePtr;
@@ -123,6 +124,11 @@ fail:
 	return NULL;
 }
 
+struct dir *parse_path(char *path_name, char *file_name)
+{
+	return parse_path_at(thread_current()->cur_dir, path_name, file_name);
+}
+
 /* Creates a file named NAME with the given INITIAL_SIZE.
  * Returns true if successful, false otherwise.
  * Fails if a file named NAME already exists,
@@ -162,10 +168,18 @@ bool filesys_create(const char *name, off_t initial_size) // name: file_path
    이름이 NAME인 파일이 없거나 내부 메모리 할당이 실패할 경우 실패*/
 struct file *
 filesys_open(const char *name)
+{
+	return filesys_open_at(thread_current()->cur_dir, name);
+}
+
+/* filesys_open() 과 같지만 상대 경로 NAME 을 현재 스레드가 아닌 CWD 기준으로 해석.
+   다른 프로세스 대신 파일을 여는 커널 스레드가 쓴다 */
+struct file *
+filesys_open_at(struct dir *cwd, const char *name)
 {
 	// struct dir *dir = dir_open_root();
 	char file_name[NAME_MAX + 1];
-	struct dir *dir = parse_path(name, file_name);
+	struct dir *dir = parse_path_at(cwd, name, file_name);
 
 	struct inode *inode = NULL;
 	// char cp_name[15] = *name;
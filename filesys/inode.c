@@ -6,6 +6,7 @@
 #include "filesys/filesys.h"
 #include "filesys/free-map.h"
 #include "threads/malloc.h"
+#include "threads/synch.h"
 #include "filesys/fat.h"
 
 /* Identifies an inode. */
@@ -38,6 +39,7 @@ struct inode
 	int open_cnt;			/* Number of openers. */
 	bool removed;			/* True if deleted, false otherwise. */
 	int deny_write_cnt;		/* 0: writes ok, >0: deny writes. */
+	struct rwlock rwlock;	/* Guards data and file contents. */
 	struct inode_disk data; /* Inode content. */
 };
 
@@ -72,10 +74,15 @@ byte_to_sector(const struct inode *inode, off_t pos)
  * returns the same `struct inode'. */
 static struct list open_inodes;
 
+/* Guards open_inodes and every inode's open_cnt.  Taken before
+ * the FAT lock and never while holding an inode's rwlock. */
+static struct lock open_inodes_lock;
+
 /* Initializes the inode module. */
 void inode_init(void)
 {
 	list_init(&open_inodes);
+	lock_init(&open_inodes_lock);
 }
 
 /* Initializes an inode with LENGTH bytes of data and
@@ -146,13 +153,15 @@ inode_open(disk_sector_t sector)
 	struct inode *inode;
 
 	/* Check whether this inode is already open. */
+	lock_acquire(&open_inodes_lock);
 	for (e = list_begin(&open_inodes); e != list_end(&open_inodes);
 		 e = list_next(e))
 	{
 		inode = list_entry(e, struct inode, elem);
 		if (inode->sector == sector)
 		{
-			inode_reopen(inode); // inode cnt증가
+			inode->open_cnt++; // inode cnt증가
+			lock_release(&open_inodes_lock);
 			return inode;
 		}
 	}
@@ -160,15 +169,21 @@ inode_open(disk_sector_t sector)
 	/* Allocate memory. */
 	inode = malloc(sizeof *inode);
 	if (inode == NULL)
+	{
+		lock_release(&open_inodes_lock);
 		return NULL;
+	}
 
-	/* Initialize. */
+	/* Initialize.  Keep the list locked until the on-disk inode
+	 * has been read, so nobody else finds it half built. */
 	list_push_front(&open_inodes, &inode->elem);
 	inode->sector = sector;
 	inode->open_cnt = 1;
 	inode->deny_write_cnt = 0;
 	inode->removed = false;
+	rwlock_init(&inode->rwlock);
 	disk_read(filesys_disk, inode->sector, &inode->data);
+	lock_release(&open_inodes_lock);
 	return inode;
 }
 
@@ -177,7 +192,11 @@ struct inode *
 inode_reopen(struct inode *inode)
 {
 	if (inode != NULL)
+	{
+		lock_acquire(&open_inodes_lock);
 		inode->open_cnt++;
+		lock_release(&open_inodes_lock);
+	}
 	return inode;
 }
 
@@ -198,6 +217,7 @@ void inode_close(struct inode *inode)
 		return;
 
 	/* Release resources if this was the last opener. */
+	lock_acquire(&open_inodes_lock);
 	if (--inode->open_cnt == 0)
 	{
 		/* Remove from inode list and release lock. */
@@ -216,6 +236,7 @@ void inode_close(struct inode *inode)
 		disk_write(filesys_disk, inode->sector, &inode->data);
 		free(inode);
 	}
+	lock_release(&open_inodes_lock);
 }
 
 /* Marks INODE to be deleted when it is closed by the last caller who
@@ -228,18 +249,19 @@ void inode_remove(struct inode *inode)
 
 /* Reads SIZE bytes from INODE into BUFFER, starting at position OFFSET.
  * Returns the number of bytes actually read, which may be less
- * than SIZE if an error occurs or end of file is reached. */
+ * than SIZE if an error occurs or end of file is reached.
+ * Readers of the same inode proceed in parallel. */
 off_t inode_read_at(struct inode *inode, void *buffer_, off_t size, off_t offset)
 {
 	uint8_t *buffer = buffer_;
 	off_t bytes_read = 0;
 	uint8_t *bounce = NULL;
 
+	rwlock_acquire_read(&inode->rwlock);
 	while (size > 0)
 	{
 		/* Disk sector to read, starting byte offset within sector. */
-		disk_sector_t sector_idx = byte_to_sector(inode, offset);
-
+		disk_sector_t sector_idx;
 		int sector_ofs = offset % DISK_SECTOR_SIZE;
 
 		/* Bytes left in inode, bytes left in sector, lesser of the two. */
@@ -252,6 +274,10 @@ off_t inode_read_at(struct inode *inode, void *buffer_, off_t size, off_t offset
 		if (chunk_size <= 0)
 			break;
 
+		/* Only look up the sector once we know it lies inside the
+		 * file: byte_to_sector() grows the chain past EOF, which a
+		 * reader must not do. */
+		sector_idx = byte_to_sector(inode, offset);
 		if (sector_ofs == 0 && chunk_size == DISK_SECTOR_SIZE)
 		{
 			/* Read full sector directly into caller's buffer. */
@@ -278,6 +304,7 @@ off_t inode_read_at(struct inode *inode, void *buffer_, off_t size, off_t offset
 		offset += chunk_size;
 		bytes_read += chunk_size;
 	}
+	rwlock_release_read(&inode->rwlock);
 
 	free(bounce);
 
@@ -297,8 +324,12 @@ off_t inode_write_at(struct inode *inode, const void *buffer_, off_t size,
 	uint8_t *bounce = NULL;
 	off_t origin_offset = offset;
 
+	rwlock_acquire_write(&inode->rwlock);
 	if (inode->deny_write_cnt)
+	{
+		rwlock_release_write(&inode->rwlock);
 		return 0;
+	}
 
 	while (size > 0)
 	{
@@ -353,6 +384,7 @@ off_t inode_write_at(struct inode *inode, const void *buffer_, off_t size,
 	/* file growth 됬을 때 inode의 length 갱신 */
 	if (inode_length(inode) < origin_offset + bytes_written)
 		inode->data.length = origin_offset + bytes_written;
+	rwlock_release_write(&inode->rwlock);
 
 	return bytes_written;
 }
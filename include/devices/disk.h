@@ -2,6 +2,7 @@
 #define DEVICES_DISK_H
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* Size of a disk sector in bytes. */
@@ -21,6 +22,7 @@ void disk_print_stats (void);
 struct disk *disk_get (int chan_no, int dev_no);
 disk_sector_t disk_size (struct disk *);
 void disk_read (struct disk *, disk_sector_t, void *);
+bool disk_read_timeout (struct disk *, disk_sector_t, void *, int64_t ticks);
 void disk_write (struct disk *, disk_sector_t, const void *);
 
 void 	register_disk_inspect_intr ();
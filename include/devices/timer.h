@@ -2,16 +2,31 @@
 #define DEVICES_TIMER_H
 
 #include <round.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* Number of timer interrupts per second. */
 #define TIMER_FREQ 100
 
+/* Nanoseconds per second. */
+#define NSEC_PER_SEC 1000000000LL
+
+/* If true, use dynamic ticks while idle.
+   Controlled by kernel command-line option "-tickless". */
+extern bool timer_tickless;
+
 void timer_init (void);
 void timer_calibrate (void);
 
 int64_t timer_ticks (void);
 int64_t timer_elapsed (int64_t);
+int64_t timer_interrupts (void);
+
+void timer_idle_enter (void);
+void timer_idle_exit (void);
+
+int64_t timer_clock_ns (void);
+void timer_sleep_until_ns (int64_t deadline);
 
 void timer_sleep (int64_t ticks);
 void timer_msleep (int64_t milliseconds);
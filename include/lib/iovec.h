@@ -0,0 +1,16 @@
+#ifndef __LIB_IOVEC_H
+#define __LIB_IOVEC_H
+
+#include <stddef.h>
+
+/* One segment of a scatter/gather list, as taken by the readv()
+   and writev() system calls. */
+struct iovec {
+	void *iov_base;                 /* Start of the segment. */
+	size_t iov_len;                 /* Length of the segment in bytes. */
+};
+
+/* Most segments one readv() or writev() call accepts. */
+#define IOV_MAX 64
+
+#endif /* lib/iovec.h */
@@ -4,5 +4,7 @@
 void console_init (void);
 void console_panic (void);
 void console_print_stats (void);
+void console_acquire (void);
+void console_release (void);
 
 #endif /* lib/kernel/console.h */
@@ -0,0 +1,73 @@
+#ifndef __LIB_KERNEL_HEAP_H
+#define __LIB_KERNEL_HEAP_H
+
+/* Priority queue.
+ *
+ * This is a pairing heap.  Like the doubly linked list in
+ * list.h, it does not require dynamically allocated memory:
+ * each structure that is a potential heap element must embed a
+ * `struct heap_elem' member, and heap_entry() converts a
+ * `struct heap_elem' back to the structure that contains it.
+ *
+ * The heap is ordered by a caller-supplied "less" function.
+ * heap_top() returns the least element.  Elements that compare
+ * equal come out in the order they were inserted, so a heap can
+ * replace a FIFO list whose elements were kept sorted with
+ * list_insert_ordered().
+ *
+ * Costs, for a heap of N elements:
+ *
+ *   - heap_top(): O(1).
+ *   - heap_insert(): O(1).
+ *   - heap_pop(), heap_remove(), heap_update(): O(log N)
+ *     amortized. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Heap element. */
+struct heap_elem {
+	struct heap_elem *child;    /* Leftmost child. */
+	struct heap_elem *next;     /* Next sibling. */
+	struct heap_elem *prev;     /* Previous sibling, or parent if
+	                               this is the leftmost child. */
+	unsigned long seq;          /* Insertion order, for ties. */
+};
+
+/* Converts pointer to heap element HEAP_ELEM into a pointer to
+   the structure that HEAP_ELEM is embedded inside.  Supply the
+   name of the outer structure STRUCT and the member name MEMBER
+   of the heap element. */
+#define heap_entry(HEAP_ELEM, STRUCT, MEMBER)           \
+	((STRUCT *) ((uint8_t *) &(HEAP_ELEM)->child     \
+		- offsetof (STRUCT, MEMBER.child)))
+
+/* Compares the value of two heap elements A and B, given
+   auxiliary data AUX.  Returns true if A is less than B, or
+   false if A is greater than or equal to B. */
+typedef bool heap_less_func (const struct heap_elem *a,
+                             const struct heap_elem *b,
+                             void *aux);
+
+/* Heap. */
+struct heap {
+	struct heap_elem *root;     /* Least element, or NULL. */
+	size_t size;                /* Number of elements. */
+	unsigned long next_seq;     /* Next insertion sequence number. */
+	heap_less_func *less;       /* Comparison function. */
+	void *aux;                  /* Auxiliary data for `less'. */
+};
+
+void heap_init (struct heap *, heap_less_func *, void *aux);
+
+bool heap_empty (const struct heap *);
+size_t heap_size (const struct heap *);
+struct heap_elem *heap_top (const struct heap *);
+
+void heap_insert (struct heap *, struct heap_elem *);
+struct heap_elem *heap_pop (struct heap *);
+void heap_remove (struct heap *, struct heap_elem *);
+void heap_update (struct heap *, struct heap_elem *);
+
+#endif /* lib/kernel/heap.h */
@@ -0,0 +1,18 @@
+#ifndef __LIB_SCHED_STATS_H
+#define __LIB_SCHED_STATS_H
+
+/* Scheduler statistics for one thread, as reported by the
+   sched_stats() system call.  All times are in timer ticks. */
+struct sched_stats {
+	int tid;                        /* Thread identifier. */
+	char name[16];                  /* Thread name. */
+	int priority;                   /* Current effective priority. */
+	long long cpu_ticks;            /* Time spent running. */
+	long long ready_ticks;          /* Time spent waiting in the run queue. */
+	long long lock_ticks;           /* Time spent blocked in lock_acquire(). */
+	long long voluntary_switches;   /* Times switched out while blocking. */
+	long long involuntary_switches; /* Times switched out while runnable. */
+	long long deadline_misses;      /* Jobs finished late, EDF only. */
+};
+
+#endif /* lib/sched-stats.h */
@@ -36,6 +36,25 @@ enum {
 
 	SYS_MOUNT,
 	SYS_UMOUNT,
+
+	/* Scheduler statistics. */
+	SYS_SCHED_STATS,            /* Read per-thread scheduler accounting. */
+	SYS_SET_TICKETS,            /* Set this process's CPU share. */
+	SYS_SCHED_DEADLINE,         /* Join or leave the EDF class. */
+	SYS_SCHED_WAIT_PERIOD,      /* Finish this period's EDF job. */
+
+	/* Vectored I/O. */
+	SYS_READV,                  /* Read into a scatter list. */
+	SYS_WRITEV,                 /* Write from a gather list. */
+
+	/* Positional I/O. */
+	SYS_PREAD,                  /* Read at an offset. */
+	SYS_PWRITE,                 /* Write at an offset. */
+	SYS_COPY_FILE_RANGE,        /* Copy between files in the kernel. */
+
+	/* Batched system calls. */
+	SYS_URING_SETUP,            /* Map submission/completion rings. */
+	SYS_URING_ENTER,            /* Run or wait for queued requests. */
 };
 
 #endif /* lib/syscall-nr.h */
@@ -0,0 +1,80 @@
+#ifndef __LIB_URING_H
+#define __LIB_URING_H
+
+#include <stdint.h>
+
+/* Batched system calls through shared rings.
+
+   uring_setup() maps a struct uring into the process.  The
+   process queues requests in the submission ring and advances
+   sq_tail; the kernel runs them in order, advancing sq_head, and
+   posts one completion per request in the completion ring,
+   advancing cq_tail.  The process takes completions and advances
+   cq_head.  The head and tail counters run freely and are
+   reduced modulo the ring size to index the rings.
+
+   Requests run either when the process calls uring_enter(), or,
+   with URING_SETUP_SQPOLL, in a kernel worker that polls the
+   submission ring.  A worker that has found nothing to do for a
+   while sets URING_NEED_WAKEUP and sleeps until the next
+   uring_enter().
+
+   Data moves only through the ring's own buffer area: a request
+   names its buffer by offset into BUF.  The kernel never touches
+   other process memory on the ring's behalf, which is what lets
+   the worker run requests outside the process. */
+
+#define URING_SQ_ENTRIES 64             /* Power of 2. */
+#define URING_CQ_ENTRIES 128            /* Power of 2. */
+#define URING_BUF_SIZE (16 * 1024)      /* Bytes in the buffer area. */
+
+/* Request opcodes. */
+enum uring_op {
+	URING_OP_NOP,                   /* Do nothing; completes with 0. */
+	URING_OP_READ,                  /* read() into BUF. */
+	URING_OP_WRITE,                 /* write() from BUF. */
+	URING_OP_OPEN,                  /* open() the file named at BUF. */
+	URING_OP_CLOSE,                 /* close() FD. */
+};
+
+/* Submission queue entry. */
+struct uring_sqe {
+	uint8_t opcode;                 /* enum uring_op. */
+	uint8_t pad[3];
+	int32_t fd;                     /* File descriptor. */
+	uint32_t buf;                   /* Offset of the data in BUF. */
+	uint32_t len;                   /* Bytes to read or write. */
+	int32_t off;                    /* File offset, or -1 for the
+	                                   file's position. */
+	uint32_t pad2;
+	uint64_t user_data;             /* Passed back in the completion. */
+};
+
+/* Completion queue entry. */
+struct uring_cqe {
+	uint64_t user_data;             /* From the request. */
+	int32_t res;                    /* What the system call would
+	                                   have returned. */
+	uint32_t pad;
+};
+
+/* uring_setup() flags. */
+#define URING_SETUP_SQPOLL 0x1          /* Run requests in a kernel worker. */
+
+/* Bits in struct uring's FLAGS, set by the kernel. */
+#define URING_NEED_WAKEUP 0x1           /* Worker asleep: call uring_enter(). */
+
+/* The shared area. */
+struct uring {
+	volatile uint32_t sq_head;      /* Next request the kernel takes. */
+	volatile uint32_t sq_tail;      /* Next request the process fills. */
+	volatile uint32_t cq_head;      /* Next completion the process takes. */
+	volatile uint32_t cq_tail;      /* Next completion the kernel fills. */
+	volatile uint32_t flags;        /* URING_NEED_WAKEUP. */
+	uint32_t pad[11];
+	struct uring_sqe sq[URING_SQ_ENTRIES];
+	struct uring_cqe cq[URING_CQ_ENTRIES];
+	uint8_t buf[URING_BUF_SIZE];    /* Data for the requests. */
+};
+
+#endif /* lib/uring.h */
@@ -4,6 +4,9 @@
 #include <stdbool.h>
 #include <debug.h>
 #include <stddef.h>
+#include <sched-stats.h>
+#include <iovec.h>
+#include <uring.h>
 
 /* Process identifier. */
 typedef int pid_t;
@@ -50,6 +53,26 @@ bool isdir (int fd);
 int inumber (int fd);
 int symlink (const char* target, const char* linkpath);
 
+/* Scheduling. */
+int sched_stats (struct sched_stats *buf, int max);
+int set_tickets (int tickets);
+bool sched_deadline (int runtime, int deadline, int period);
+void sched_wait_period (void);
+
+/* Vectored I/O. */
+int readv (int fd, const struct iovec *iov, int iovcnt);
+int writev (int fd, const struct iovec *iov, int iovcnt);
+
+/* Positional I/O. */
+int pread (int fd, void *buffer, unsigned length, off_t offset);
+int pwrite (int fd, const void *buffer, unsigned length, off_t offset);
+int copy_file_range (int fd_in, off_t off_in, int fd_out, off_t off_out,
+                     unsigned length);
+
+/* Batched system calls. */
+struct uring *uring_setup (void *addr, unsigned flags);
+int uring_enter (unsigned to_submit, unsigned min_complete);
+
 static inline void* get_phys_addr (void *user_addr) {
 	void* pa;
 	asm volatile ("movq %0, %%rax" ::"r"(user_addr));
@@ -0,0 +1,48 @@
+#ifndef THREADS_PROFILE_H
+#define THREADS_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct intr_frame;
+
+/* Statistical CPU profiler.
+
+   When the kernel is started with `-o profile', each CPU's timer
+   tick samples whatever it interrupted: the instruction pointer,
+   the privilege level, the CPU and the running thread, plus the
+   return addresses found by following the frame-pointer chain.
+   Each CPU keeps its samples in an in-memory ring of its own.
+   The rings are written to the scratch disk at power-off, where
+   utils/pintos-profile turns them into folded stacks for flame
+   graphs. */
+
+/* Return addresses kept per sample, including the interrupted
+   instruction itself.  Fills out a 128-byte sample. */
+#define PROFILE_DEPTH 13
+
+/* One sample.  The on-disk layout must match
+   utils/pintos-profile. */
+struct profile_sample {
+	int32_t tid;                /* Running thread. */
+	uint8_t cpl;                /* Privilege level: 0 kernel, 3 user. */
+	uint8_t depth;              /* Valid entries in PC. */
+	uint8_t cpu;                /* CPU that took the sample. */
+	uint8_t pad;
+	char name[16];              /* Thread name, to find user binaries. */
+	uint64_t pc[PROFILE_DEPTH]; /* Interrupted RIP, then callers. */
+};
+
+/* `-o profile': take samples?  Set while parsing the command line;
+   sampling starts once profile_init() has run. */
+extern bool profile_enabled;
+
+/* `-profile-hz=N': samples per second, at most TIMER_FREQ. */
+extern int profile_hz;
+
+void profile_init (void);
+void profile_init_cpu (void);
+void profile_sample (const struct intr_frame *);
+void profile_dump (void);
+
+#endif /* threads/profile.h */
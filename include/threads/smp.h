@@ -0,0 +1,76 @@
+#ifndef THREADS_SMP_H
+#define THREADS_SMP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Symmetric multiprocessing.
+
+   The boot processor (BSP) finds the other CPUs, the application
+   processors (APs), in the MP configuration table the BIOS
+   leaves in low memory, and starts each one with an INIT and two
+   STARTUP IPIs through its local APIC.  An AP comes up in real
+   mode at AP_START (see loader.h), where threads/ap-start.S takes it to long
+   mode on the boot page tables and then into ap_main() on the
+   stack of its own idle thread.
+
+   Kernel code still relies on intr_disable() for mutual
+   exclusion in many places, which only holds off the local CPU.
+   So at most one CPU runs kernel code at a time: a CPU takes the
+   kernel lock whenever it enters the kernel, through an
+   interrupt or a system call, and gives it up when it returns to
+   user mode or halts in its idle loop.  User code runs on all
+   CPUs in parallel.  The lock belongs to a CPU, not a thread, so
+   a context switch hands it from the old thread to the new one.
+   Until the kernel lock is split up, the run queue spinlocks and
+   the other kernel spinlocks are only ever taken by the CPU that
+   holds it, so scheduling itself is still serialized.
+
+   Each CPU has its own run queue and idle thread (see thread.c).
+   Kernel threads stay on the BSP, which owns the PIT and the
+   devices; user processes may run anywhere, and an idle CPU
+   steals them from busy ones. */
+
+/* Most CPUs the kernel will start. */
+#define CPU_MAX 8
+
+/* Interrupt vectors raised by the local APIC, above all of the
+   exceptions and PIC interrupts. */
+#define LAPIC_TIMER_VEC 0xf0        /* Local APIC timer, on the APs. */
+#define LAPIC_RESCHED_VEC 0xf1      /* Reschedule IPI. */
+#define LAPIC_SPURIOUS_VEC 0xff     /* Spurious interrupt. */
+
+struct task_state;
+
+/* A CPU. */
+struct cpu {
+	/* syscall_entry reaches these through %gs, so they must come
+	   first and stay in this order. */
+	uint64_t user_rsp;              /* User %rsp during syscall entry. */
+	struct task_state *tss;         /* This CPU's TSS. */
+
+	int id;                         /* Index in cpus[]. */
+	uint8_t apic_id;                /* Local APIC ID. */
+	volatile bool started;          /* Done with ap_main()'s setup? */
+
+	/* Sampling profiler (see profile.c). */
+	struct profile_sample *prof_ring; /* Ring of samples, or null. */
+	uint64_t prof_head;             /* Samples taken so far. */
+	int prof_countdown;             /* Ticks until the next sample. */
+};
+
+extern struct cpu cpus[CPU_MAX];
+extern int cpu_cnt;
+
+void smp_init (void);
+int cpu_id (void);
+struct cpu *cpu_current (void);
+
+void smp_send_resched (int cpu);
+void lapic_eoi (void);
+
+void kernel_lock_acquire (void);
+void kernel_lock_release (void);
+bool kernel_lock_held (void);
+
+#endif /* threads/smp.h */
@@ -0,0 +1,27 @@
+#ifndef THREADS_SWITCH_H
+#define THREADS_SWITCH_H
+
+#include <stdint.h>
+
+struct intr_frame;
+
+/* Kernel-to-kernel context switch.
+
+   Every switch between threads happens inside schedule(), a
+   function call, so only what the calling convention asks a
+   callee to preserve has to be saved: the callee-saved
+   registers, which are pushed onto the outgoing thread's stack,
+   and the stack pointer itself, which is stored in *CUR_STACK.
+   Interrupted user or kernel state is already on the stack in
+   the interrupt frame built by intr-stubs.S. */
+
+/* Switches to the thread whose stack pointer was saved at
+   NEXT_STACK.  Returns when the current thread is switched back
+   to. */
+void switch_threads (uint8_t **cur_stack, uint8_t *next_stack);
+
+/* Saves the current thread as switch_threads() does, then enters
+   a thread that has never run through the interrupt frame TF. */
+void switch_to_new (uint8_t **cur_stack, struct intr_frame *tf);
+
+#endif /* threads/switch.h */
@@ -1,17 +1,21 @@
 #ifndef THREADS_SYNCH_H
 #define THREADS_SYNCH_H
 
+#include <heap.h>
 #include <list.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "threads/interrupt.h"
 
 /* A counting semaphore. */
 struct semaphore {
 	unsigned value;             /* Current value. */
-	struct list waiters;        /* List of waiting threads. */
+	struct heap waiters;        /* Waiting threads, highest priority first. */
 };
 
 void sema_init (struct semaphore *, unsigned value);
 void sema_down (struct semaphore *);
+bool sema_down_timeout (struct semaphore *, int64_t ticks);
 bool sema_try_down (struct semaphore *);
 void sema_up (struct semaphore *);
 void sema_self_test (void);
@@ -20,27 +24,78 @@ void sema_self_test (void);
 struct lock {
 	struct thread *holder;      /* Thread holding lock (for debugging). */
 	struct semaphore semaphore; /* Binary semaphore controlling access. */
+#ifdef LOCKSTAT
+	void *init_site;            /* Caller of lock_init(). */
+	struct lockstat *stat;      /* Statistics for the current holder. */
+	int64_t acquired_at;        /* When the holder got it, in ns. */
+#endif
 };
 
 void lock_init (struct lock *);
 void lock_acquire (struct lock *);
+bool lock_acquire_timeout (struct lock *, int64_t ticks);
 bool lock_try_acquire (struct lock *);
 void lock_release (struct lock *);
 bool lock_held_by_current_thread (const struct lock *);
 
+#ifdef LOCKSTAT
+/* Lock contention statistics, built in with `make LOCKSTAT=1'.
+   Every lock is counted under the pair of call sites that
+   initialized and acquired it, so that all the locks of one kind
+   (say, every inode's) taken from one place share an entry. */
+void lockstat_print (void);
+#endif
+
+/* Readers-writer lock.  Any number of readers may hold it at
+   once, or a single writer.  A writer holds LOCK for as long as
+   it owns the rwlock, so threads that block behind a writer
+   donate their priority to it through the ordinary lock
+   machinery.  Readers pass through LOCK only briefly, and a
+   waiting writer keeps holding it, so new readers queue up
+   behind a waiting writer instead of starving it. */
+struct rwlock {
+	struct lock lock;           /* Held by the writer. */
+	unsigned readers;           /* Number of readers holding it. */
+	bool writer_waiting;        /* A writer waits for readers to drain. */
+	struct semaphore drained;   /* Up'd by the last reader out. */
+};
+
+void rwlock_init (struct rwlock *);
+void rwlock_acquire_read (struct rwlock *);
+void rwlock_release_read (struct rwlock *);
+void rwlock_acquire_write (struct rwlock *);
+void rwlock_release_write (struct rwlock *);
+bool rwlock_held_for_write (const struct rwlock *);
+
+/* Spinlock.  Guards data that interrupt handlers (and, on a
+   multiprocessor, other CPUs) also touch.  Holding a spinlock
+   keeps interrupts off on the local CPU, so the holder must not
+   sleep, and nested spinlocks must be released in the reverse
+   order of acquisition. */
+struct spinlock {
+	volatile int locked;        /* Nonzero while held. */
+	void *holder;               /* Stack page of holder (for debugging). */
+	enum intr_level old_level;  /* Interrupt level before acquiring. */
+};
+
+void spinlock_init (struct spinlock *);
+void spinlock_acquire (struct spinlock *);
+void spinlock_release (struct spinlock *);
+bool spinlock_held_by_current_thread (const struct spinlock *);
+
 /* Condition variable. */
 struct condition {
-	struct list waiters;        /* List of waiting threads. */
+	struct heap waiters;        /* Waiters, highest priority first. */
 };
 
 void cond_init (struct condition *);
 void cond_wait (struct condition *, struct lock *);
+bool cond_wait_timeout (struct condition *, struct lock *, int64_t ticks);
 void cond_signal (struct condition *, struct lock *);
 void cond_broadcast (struct condition *, struct lock *);
 
-/* 첫 번째 인자의 우선순위가 두 번째 인자의 우선순위보다 높으면 1을 반환 낮으면 0을 반환 */
-bool cmp_sem_priority (const struct list_elem *a, const struct list_elem *b,
-void *aux);
+void synch_requeue (struct thread *);
+void synch_cancel_wait (struct thread *);
 
 /* Optimization barrier.
  *
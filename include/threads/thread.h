@@ -5,8 +5,11 @@
 #define MAX_FD_NUM FDT_PAGES*(1 << 9)
 
 #include <debug.h>
+#include <heap.h>
 #include <list.h>
+#include <sched-stats.h>
 #include <stdint.h>
+#include "threads/fixed_point.h"
 #include "threads/interrupt.h"
 #include "threads/synch.h"
 #ifdef VM
@@ -33,6 +36,16 @@ typedef int tid_t;
 #define PRI_DEFAULT 31 /* Default priority. */
 #define PRI_MAX 63	   /* Highest priority. */
 
+/* Thread niceness, for the 4.4BSD scheduler. */
+#define NICE_MIN -20	/* Nicest to other threads. */
+#define NICE_DEFAULT 0	/* Default niceness. */
+#define NICE_MAX 20		/* Least nice to other threads. */
+
+/* Lottery tickets, for the stride scheduler. */
+#define TICKETS_MIN 1		/* Smallest share. */
+#define TICKETS_DEFAULT 100	/* Default share. */
+#define TICKETS_MAX 10000	/* Largest share. */
+
 /* A kernel thread or user process.
  *
  * Each thread structure is stored in its own 4 kB page.  The
@@ -96,21 +109,57 @@ struct thread
 	tid_t tid;				   /* Thread identifier. */
 	enum thread_status status; /* Thread state. */
 	char name[16];			   /* Name (for debugging purposes). */
-	uint8_t *stack;			   /* 악깡버 Saved stack pointer.*/
-	// struct list_elem allelem;  /* 악깡버 List element for all threads list. */
-	/* Shared between thread.c and synch.c. */
-	struct list_elem elem; /* List element. */
+	uint8_t *stack;			   /* Saved stack pointer, while switched out. */
+	int cpu;				   /* CPU it runs or last ran on, in cpus[]. */
+	struct list_elem allelem;  /* List element for all threads list. */
+	struct list_elem elem; /* Run queue element (thread.c). */
 	int64_t wakeup_tick;   /* 해당 스레드가 깨어날 시간 */
+	struct heap_elem sleep_elem; /* sleep queue element (thread.c) */
+	bool sleeping;			/* In the sleep queue? */
+	/* Owned by synch.c: the priority-ordered wait queues this
+	   thread sits in while blocked. */
+	struct heap_elem wait_elem;		/* Element in waiting_on's waiters. */
+	struct semaphore *waiting_on;	/* Semaphore being waited for. */
+	struct condition *wait_cond;	/* Condition being waited for. */
+	struct heap_elem *cond_elem;	/* Element in wait_cond's waiters. */
 	/* for priority donation */
 	int priority;					/* Priority. */
 	int init_priority;				/* donation 이후 우선순위를 초기화하기 위해 초기값 저장 */
 	struct lock *wait_on_lock;		/* 해당 스레드가 대기 하고 있는 lock자료구조의 주소를 저장 */
 	struct list donations;			/* multiple donation 을 고려하기 위해 사용 */
 	struct list_elem donation_elem; /* multiple donation 을 고려하기 위해 사용 */
+	/* for the 4.4BSD scheduler (-mlfqs) */
+	int nice;						/* Niceness, from -20 to 20. */
+	fixed_t recent_cpu;				/* Decayed CPU usage, in ticks. */
+	/* for the stride scheduler (-stride) */
+	int tickets;					/* Share of the CPU. */
+	uint64_t stride;				/* STRIDE1 / tickets. */
+	uint64_t pass;					/* Virtual time; lowest runs next. */
+	struct heap_elem stride_elem;	/* Element in the stride run queue. */
+	/* for the earliest-deadline-first class.  All in timer ticks;
+	   edf_period is 0 for threads outside the class. */
+	int64_t edf_runtime;			/* Budget per period. */
+	int64_t edf_deadline;			/* Deadline, relative to release. */
+	int64_t edf_period;				/* Time between releases. */
+	int64_t edf_budget;				/* Budget left in this period. */
+	int64_t edf_deadline_at;		/* Absolute deadline of this job. */
+	int64_t edf_next_release;		/* When the next job is released. */
+	bool edf_missed;				/* This job already missed? */
+	int64_t edf_misses;				/* Deadlines missed so far. */
+	struct heap_elem edf_elem;		/* Element in the EDF run queue. */
+	struct list_elem edf_allelem;	/* Element in the list of EDF threads. */
+	/* Scheduler accounting, in timer ticks.  See struct sched_stats. */
+	int64_t cpu_ticks;				/* Time spent running. */
+	int64_t ready_ticks;			/* Time spent in the run queue. */
+	int64_t ready_since;			/* When it last entered the run queue. */
+	int64_t lock_ticks;				/* Time spent blocked in lock_acquire(). */
+	int64_t voluntary_switches;		/* Switched out while blocking. */
+	int64_t involuntary_switches;	/* Switched out while runnable. */
 
 #ifdef USERPROG
 	/* Owned by userprog/process.c. */
 	uint64_t *pml4; /* Page map level 4 */
+	struct uring_ctx *uring; /* Submission/completion rings, if any. */
 #endif
 #ifdef VM
 	/* Table for whole virtual memory owned by thread. */
@@ -121,11 +170,12 @@ struct thread
 #endif
 
 	/* Owned by thread.c. */
-	struct intr_frame tf; /* Information for switching */
+	struct intr_frame tf; /* Initial context, for the first switch in. */
 
 	struct intr_frame parent_if; /* context switching할 때 쓰는 것 */
 	struct file **fd_table;		 /* FDT '파일을 가르키는 포인터'를 가르키는 포인터*/
 	int fdidx;					 /* 쓰레드가 관리하는 여러 파일 중 FDT 파일에 대한 idx */
+	struct lock fd_lock;		 /* fd_table 과 그 file 들의 위치 보호 (ring worker 와 공유) */
 
 	struct file *run_file;
 	
@@ -147,14 +197,33 @@ struct thread
    Controlled by kernel command-line option "-o mlfqs". */
 extern bool thread_mlfqs;
 
+/* If true, use the stride (proportional-share) scheduler.
+   Controlled by kernel command-line option "-stride". */
+extern bool thread_stride;
+
+/* Most dead threads' pages and fd tables kept for reuse.
+   Controlled by kernel command-line option "-thread-cache". */
+#define THREAD_CACHE_DEFAULT 16
+extern int thread_cache_max;
+
+/* If true, switch threads by saving and restoring a whole
+   interrupt frame, as before switch_threads() existed.  For
+   comparison only.  Controlled by "-switch=iret". */
+extern bool thread_iret_switch;
+
 void thread_init(void);
 void thread_start(void);
+struct thread *thread_create_idle(int cpu);
+void thread_start_cpu(void) NO_RETURN;
 
 void thread_tick(void);
+void thread_idle_ticks(int cpu, int64_t ticks);
 void thread_print_stats(void);
+int thread_get_stats(struct sched_stats *, int max);
 
 typedef void thread_func(void *aux);
 tid_t thread_create(const char *name, int priority, thread_func *, void *);
+void thread_fdt_free(struct file **);
 
 void thread_block(void);
 void thread_unblock(struct thread *);
@@ -174,18 +243,27 @@ void thread_set_nice(int);
 int thread_get_recent_cpu(void);
 int thread_get_load_avg(void);
 
+int thread_get_tickets(void);
+int thread_set_tickets(int);
+
+bool thread_set_deadline(int64_t runtime, int64_t deadline, int64_t period);
+void thread_wait_period(void);
+void thread_edf_release(int64_t ticks);
+
 void thread_sleep(int64_t ticks);			   /* 실행 중인 스레드를 슬립으로 만듬 */
+void thread_sleep_cancel(struct thread *t);	   /* 타임아웃 대기 중인 스레드를 슬립큐에서 제거 */
 void thread_awake(int64_t ticks);			   /* 슬립큐에서 깨워야할 스레드를 깨움 */
 void update_next_tick_to_awake(int64_t ticks); /* 최소 틱을 가진 스레드 저장 */
 int64_t get_next_tick_to_awake(void);		   /* thread.c의 next_tick_to_awake 반환 */
 
+bool runq_preempts(struct thread *cur);												   /* 실행 중인 CPU의 run queue에 CUR보다 먼저 돌아야 할 스레드가 있는지 */
 void test_max_priority(void);															   /* 현재 수행중인 스레드와 가장 높은 우선순위의 스레드의 우선순위를 비교하여 스케줄링 */
-bool cmp_priority(const struct list_elem *a, const struct list_elem *b, void *aux UNUSED); /* 인자로 주어진 스레드들의 우선순위를 비교 */
 bool cmp_don_priority(const struct list_elem *a, const struct list_elem *b, void *aux UNUSED);
 
 void donate_priority(void);
 void remove_with_lock(struct lock *lock); /* lock 을 해지 했을때 donations 리스트에서 해당 엔트리를 삭제 하기 위한 함수 */
 void refresh_priority(void);
+void refresh_priority_chain(struct thread *t);
 
 void do_iret(struct intr_frame *tf);
 
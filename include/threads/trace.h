@@ -0,0 +1,54 @@
+#ifndef THREADS_TRACE_H
+#define THREADS_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Scheduler event tracing.
+
+   When the kernel is started with -trace, the scheduler records
+   events into an in-memory ring, each stamped with the TSC.  The
+   ring keeps the most recent TRACE_EVENT_CNT events and is
+   written to the scratch disk at power-off, where
+   utils/sched-trace can turn it into per-thread latency
+   histograms. */
+
+/* Event types.  The on-disk layout must match utils/sched-trace. */
+enum trace_type {
+	TRACE_CREATE = 1,           /* Thread created: NAME. */
+	TRACE_SWITCH,               /* Switched to ARG[0], TID left in state ARG[1]. */
+	TRACE_UNBLOCK,              /* TID made ready at priority ARG[0]. */
+	TRACE_DONATE,               /* TID donated priority ARG[1] to ARG[0]. */
+	TRACE_SEMA_BLOCK,           /* TID blocked on semaphore ARG[0] (low bits). */
+};
+
+/* One trace event.  32 bytes. */
+struct trace_event {
+	uint64_t tsc;               /* Time stamp counter. */
+	uint16_t type;              /* One of enum trace_type. */
+	uint16_t pad;
+	int32_t tid;                /* Thread the event is about. */
+	union {
+		int32_t arg[4];
+		char name[16];          /* TRACE_CREATE only. */
+	};
+};
+
+/* -trace: record scheduler events?  Set while parsing the command
+   line; recording starts once trace_init() has run. */
+extern bool trace_enabled;
+
+void trace_init (void);
+void trace_record (enum trace_type, int tid, int arg0, int arg1);
+void trace_record_create (int tid, const char *name);
+void trace_dump (void);
+
+/* Records an event if tracing is on.  Cheap enough to leave in
+   the scheduler's hot paths when it is off. */
+#define TRACE(TYPE, TID, ARG0, ARG1)                            \
+	do {                                                        \
+		if (trace_enabled)                                      \
+			trace_record (TYPE, TID, ARG0, ARG1);               \
+	} while (0)
+
+#endif /* threads/trace.h */
@@ -0,0 +1,71 @@
+#ifndef THREADS_WORKQUEUE_H
+#define THREADS_WORKQUEUE_H
+
+#include <heap.h>
+#include <list.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "threads/synch.h"
+
+/* Deferred work.
+
+   A workqueue is a FIFO of work items served by a small pool of
+   kernel worker threads.  Interrupt handlers and other code on a
+   latency-critical path hand off the slow part of their job by
+   queueing a work item, which a worker later runs in thread
+   context, where it may sleep, take locks and do I/O.
+
+   A delayed work item is queued once a given number of timer
+   ticks has passed.  The timer interrupt checks for expired
+   delayed work the same way it checks for sleeping threads. */
+
+struct work;
+struct workqueue;
+
+/* Runs a work item.  Called in a worker thread. */
+typedef void work_func (struct work *);
+
+/* A unit of deferred work.  Embed it in a larger structure and
+   use work_entry() to get back to the container. */
+struct work {
+	struct list_elem elem;      /* Element in workqueue's items. */
+	work_func *func;            /* Function to run. */
+	bool pending;               /* Queued but not yet started? */
+	struct workqueue *wq;       /* Queue it was last put on. */
+};
+
+/* Work that is queued once its timer expires. */
+struct delayed_work {
+	struct work work;           /* The work to queue. */
+	struct workqueue *wq;       /* Where to queue it. */
+	int64_t expires;            /* Tick at which to queue it. */
+	struct heap_elem timer_elem;/* Element in the delayed heap. */
+	bool timer_armed;           /* On the delayed heap? */
+};
+
+/* Converts pointer to work item WORK into a pointer to the
+   structure STRUCT that it is embedded inside as MEMBER. */
+#define work_entry(WORK, STRUCT, MEMBER)                        \
+	((STRUCT *) ((uint8_t *) (WORK) - offsetof (STRUCT, MEMBER)))
+
+/* Shared queue for work that does not need its own workers. */
+extern struct workqueue *system_wq;
+
+void workqueue_init (void);
+struct workqueue *workqueue_create (const char *name, int worker_cnt);
+
+void work_init (struct work *, work_func *);
+bool queue_work (struct workqueue *, struct work *);
+bool cancel_work (struct work *);
+void flush_workqueue (struct workqueue *);
+
+void delayed_work_init (struct delayed_work *, work_func *);
+bool queue_delayed_work (struct workqueue *, struct delayed_work *,
+		int64_t delay);
+bool cancel_delayed_work (struct delayed_work *);
+
+void workqueue_tick (int64_t now);
+int64_t workqueue_next_deadline (void);
+
+#endif /* threads/workqueue.h */
@@ -0,0 +1,25 @@
+#ifndef USERPROG_UACCESS_H
+#define USERPROG_UACCESS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct intr_frame;
+
+/* Kernel access to user memory.
+
+   These functions touch user memory directly, without first
+   looking the addresses up in the supplemental page table.  A
+   page that is merely not loaded yet is brought in by the page
+   fault handler as usual.  An access that the page fault handler
+   cannot satisfy does not kill the process: page_fault() finds
+   the faulting instruction in the exception table and resumes at
+   its fixup, and the copy reports failure to its caller. */
+
+bool copy_from_user (void *dst, const void *usrc, size_t size);
+bool copy_to_user (void *udst, const void *src, size_t size);
+long strncpy_from_user (char *dst, const char *usrc, size_t size);
+
+bool uaccess_fixup (struct intr_frame *);
+
+#endif /* userprog/uaccess.h */
@@ -0,0 +1,11 @@
+#ifndef USERPROG_URING_H
+#define USERPROG_URING_H
+
+/* Kernel side of the shared submission and completion rings
+   described in <uring.h>.  A process has at most one ring. */
+
+void *uring_setup (void *addr, unsigned flags);
+int uring_enter (unsigned to_submit, unsigned min_complete);
+void uring_destroy (void);
+
+#endif /* userprog/uring.h */
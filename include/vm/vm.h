@@ -38,6 +38,9 @@ struct thread;
 
 #define VM_TYPE(type) ((type) & 7)
 
+/* How far below USER_STACK the stack may grow. */
+#define STACK_GROWTH_MAX 0x100000
+
 /* The representation of "page".
  * This is kind of "parent class", which has four "child class"es, which are
  * uninit_page, file_page, anon_page, and page cache (project4).
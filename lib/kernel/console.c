@@ -102,6 +102,20 @@ release_console (void) {
 	}
 }
 
+/* Holds the console lock across several putbuf() or printf()
+   calls, so that their output is not mixed with other threads'.
+   May be nested.  Must be paired with console_release(). */
+void
+console_acquire (void) {
+	acquire_console ();
+}
+
+/* Releases the console lock taken by console_acquire(). */
+void
+console_release (void) {
+	release_console ();
+}
+
 /* Returns true if the current thread has the console lock,
    false otherwise. */
 static bool
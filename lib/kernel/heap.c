@@ -0,0 +1,194 @@
+/* Pairing heap.
+
+   See heap.h for basic information.  The algorithm is described
+   in M. L. Fredman, R. Sedgewick, D. D. Sleator, and R. E.
+   Tarjan, "The Pairing Heap: A New Form of Self-Adjusting Heap",
+   Algorithmica 1 (1986). */
+
+#include "heap.h"
+#include "../debug.h"
+
+static bool before (const struct heap *, const struct heap_elem *,
+		const struct heap_elem *);
+static struct heap_elem *meld (const struct heap *, struct heap_elem *,
+		struct heap_elem *);
+static struct heap_elem *merge_pairs (const struct heap *,
+		struct heap_elem *);
+static void detach (struct heap *, struct heap_elem *);
+
+/* Initializes HEAP as an empty heap ordered by LESS given
+   auxiliary data AUX. */
+void
+heap_init (struct heap *heap, heap_less_func *less, void *aux) {
+	ASSERT (heap != NULL);
+	ASSERT (less != NULL);
+
+	heap->root = NULL;
+	heap->size = 0;
+	heap->next_seq = 0;
+	heap->less = less;
+	heap->aux = aux;
+}
+
+/* Returns true if HEAP is empty, false otherwise. */
+bool
+heap_empty (const struct heap *heap) {
+	return heap->root == NULL;
+}
+
+/* Returns the number of elements in HEAP. */
+size_t
+heap_size (const struct heap *heap) {
+	return heap->size;
+}
+
+/* Returns the least element in HEAP, or a null pointer if HEAP
+   is empty. */
+struct heap_elem *
+heap_top (const struct heap *heap) {
+	return heap->root;
+}
+
+/* Inserts ELEM into HEAP. */
+void
+heap_insert (struct heap *heap, struct heap_elem *elem) {
+	ASSERT (heap != NULL);
+	ASSERT (elem != NULL);
+
+	elem->seq = heap->next_seq++;
+	elem->child = elem->next = elem->prev = NULL;
+	heap->root = meld (heap, heap->root, elem);
+	heap->size++;
+}
+
+/* Removes the least element from HEAP and returns it.
+   Undefined behavior if HEAP is empty. */
+struct heap_elem *
+heap_pop (struct heap *heap) {
+	struct heap_elem *top = heap->root;
+
+	ASSERT (top != NULL);
+
+	heap->root = merge_pairs (heap, top->child);
+	heap->size--;
+	top->child = NULL;
+	return top;
+}
+
+/* Removes ELEM, which must be in HEAP, from HEAP. */
+void
+heap_remove (struct heap *heap, struct heap_elem *elem) {
+	detach (heap, elem);
+	heap->size--;
+}
+
+/* Restores HEAP's ordering after the value that HEAP's "less"
+   function compares for ELEM has changed.  ELEM keeps its place
+   among elements that compare equal to it. */
+void
+heap_update (struct heap *heap, struct heap_elem *elem) {
+	detach (heap, elem);
+	heap->root = meld (heap, heap->root, elem);
+}
+
+/* Returns true if A should come out of HEAP before B: if A is
+   less than B, or if they are equal and A was inserted first. */
+static bool
+before (const struct heap *heap, const struct heap_elem *a,
+		const struct heap_elem *b) {
+	if (heap->less (a, b, heap->aux))
+		return true;
+	if (heap->less (b, a, heap->aux))
+		return false;
+	return (long) (a->seq - b->seq) < 0;
+}
+
+/* Combines the heap-ordered trees rooted at A and B, either of
+   which may be null, and returns the new root.  A and B must not
+   have siblings or parents. */
+static struct heap_elem *
+meld (const struct heap *heap, struct heap_elem *a, struct heap_elem *b) {
+	if (a == NULL)
+		return b;
+	if (b == NULL)
+		return a;
+	if (before (heap, b, a)) {
+		struct heap_elem *t = a;
+		a = b;
+		b = t;
+	}
+
+	/* Make B the leftmost child of A. */
+	b->prev = a;
+	b->next = a->child;
+	if (a->child != NULL)
+		a->child->prev = b;
+	a->child = b;
+	return a;
+}
+
+/* Combines the list of sibling trees starting at FIRST into one
+   tree and returns its root, using the standard two-pass
+   pairing: meld adjacent pairs from left to right, then meld the
+   results from right to left. */
+static struct heap_elem *
+merge_pairs (const struct heap *heap, struct heap_elem *first) {
+	struct heap_elem *pairs = NULL;
+	struct heap_elem *root = NULL;
+
+	/* First pass.  Push each melded pair onto PAIRS, so that the
+	   second pass sees them right to left. */
+	while (first != NULL) {
+		struct heap_elem *a = first;
+		struct heap_elem *b = a->next;
+		struct heap_elem *pair;
+
+		first = b != NULL ? b->next : NULL;
+		a->next = a->prev = NULL;
+		if (b != NULL)
+			b->next = b->prev = NULL;
+		pair = meld (heap, a, b);
+		pair->next = pairs;
+		pairs = pair;
+	}
+
+	/* Second pass. */
+	while (pairs != NULL) {
+		struct heap_elem *next = pairs->next;
+
+		pairs->next = NULL;
+		root = meld (heap, root, pairs);
+		pairs = next;
+	}
+	return root;
+}
+
+/* Unlinks ELEM from HEAP, leaving ELEM as a tree of its own with
+   no children, and puts ELEM's former children back into HEAP. */
+static void
+detach (struct heap *heap, struct heap_elem *elem) {
+	struct heap_elem *children;
+
+	ASSERT (heap != NULL);
+	ASSERT (elem != NULL);
+
+	if (elem == heap->root) {
+		heap->root = merge_pairs (heap, elem->child);
+		elem->child = NULL;
+		return;
+	}
+
+	/* Unlink ELEM from its parent or left sibling. */
+	ASSERT (elem->prev != NULL);
+	if (elem->prev->child == elem)
+		elem->prev->child = elem->next;
+	else
+		elem->prev->next = elem->next;
+	if (elem->next != NULL)
+		elem->next->prev = elem->prev;
+	elem->next = elem->prev = NULL;
+
+	children = merge_pairs (heap, elem->child);
+	elem->child = NULL;
+	heap->root = meld (heap, heap->root, children);
+}
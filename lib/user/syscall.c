@@ -54,7 +54,7 @@ static __inline int64_t syscall (uint64_t num_, uint64_t a1_, uint64_t a2_,
 			((uint64_t) ARG2), 0, 0, 0))
 
 #define syscall4(NUMBER, ARG0, ARG1, ARG2, ARG3) ( \
-		syscall(((uint64_t *) NUMBER), \
+		syscall(((uint64_t) NUMBER), \
 			((uint64_t) ARG0), \
 			((uint64_t) ARG1), \
 			((uint64_t) ARG2), \
@@ -194,3 +194,60 @@ int
 umount (const char *path) {
 	return syscall1 (SYS_UMOUNT, path);
 }
+
+int
+sched_stats (struct sched_stats *buf, int max) {
+	return syscall2 (SYS_SCHED_STATS, buf, max);
+}
+
+int
+set_tickets (int tickets) {
+	return syscall1 (SYS_SET_TICKETS, tickets);
+}
+
+bool
+sched_deadline (int runtime, int deadline, int period) {
+	return syscall3 (SYS_SCHED_DEADLINE, runtime, deadline, period);
+}
+
+void
+sched_wait_period (void) {
+	syscall0 (SYS_SCHED_WAIT_PERIOD);
+}
+
+int
+readv (int fd, const struct iovec *iov, int iovcnt) {
+	return syscall3 (SYS_READV, fd, iov, iovcnt);
+}
+
+int
+writev (int fd, const struct iovec *iov, int iovcnt) {
+	return syscall3 (SYS_WRITEV, fd, iov, iovcnt);
+}
+
+int
+pread (int fd, void *buffer, unsigned length, off_t offset) {
+	return syscall4 (SYS_PREAD, fd, buffer, length, offset);
+}
+
+int
+pwrite (int fd, const void *buffer, unsigned length, off_t offset) {
+	return syscall4 (SYS_PWRITE, fd, buffer, length, offset);
+}
+
+int
+copy_file_range (int fd_in, off_t off_in, int fd_out, off_t off_out,
+		unsigned length) {
+	return syscall5 (SYS_COPY_FILE_RANGE, fd_in, off_in, fd_out, off_out,
+			length);
+}
+
+struct uring *
+uring_setup (void *addr, unsigned flags) {
+	return (struct uring *) syscall2 (SYS_URING_SETUP, addr, flags);
+}
+
+int
+uring_enter (unsigned to_submit, unsigned min_complete) {
+	return syscall2 (SYS_URING_ENTER, to_submit, min_complete);
+}
@@ -0,0 +1,96 @@
+/* Measures how long a one-sector read of one file takes while
+   another process streams through a different, larger file.
+   With a single file system lock the small read waits for the
+   whole large read to finish; with per-inode locks the two
+   only contend for the disk one sector at a time, so the small
+   read should cost little more than it does on an idle disk. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define BIG_SIZE (64 * 512)     /* Bytes in the streamed file. */
+#define BIG_PASSES 16           /* Times the reader streams it. */
+#define SMALL_SIZE 512          /* Bytes in the probed file. */
+#define PROBE_CNT 16            /* Small reads timed per phase. */
+
+static char big[BIG_SIZE];
+static char small[SMALL_SIZE];
+
+static void
+make_file (const char *name, char *buf, size_t size)
+{
+  int fd;
+
+  memset (buf, name[0], size);
+  CHECK (create (name, size), "create \"%s\"", name);
+  CHECK ((fd = open (name)) > 1, "open \"%s\"", name);
+  if (write (fd, buf, size) != (int) size)
+    fail ("write \"%s\" failed", name);
+  close (fd);
+}
+
+/* Times PROBE_CNT reads of the whole of FD and returns their
+   average cost in cycles. */
+static unsigned long long
+probe (int fd)
+{
+  unsigned long long total = 0;
+  int i;
+
+  for (i = 0; i < PROBE_CNT; i++)
+    {
+      unsigned long long start = rdtsc ();
+
+      seek (fd, 0);
+      if (read (fd, small, SMALL_SIZE) != SMALL_SIZE)
+        fail ("read \"small\" failed");
+      total += rdtsc () - start;
+    }
+  return total / PROBE_CNT;
+}
+
+static void
+stream_big (void)
+{
+  int fd = open ("big");
+  int i;
+
+  if (fd < 2)
+    exit (1);
+  for (i = 0; i < BIG_PASSES; i++)
+    {
+      seek (fd, 0);
+      if (read (fd, big, BIG_SIZE) != BIG_SIZE)
+        exit (1);
+    }
+  exit (0);
+}
+
+void
+test_main (void)
+{
+  unsigned long long idle, loaded;
+  pid_t pid;
+  int fd;
+
+  make_file ("big", big, BIG_SIZE);
+  make_file ("small", small, SMALL_SIZE);
+  CHECK ((fd = open ("small")) > 1, "open \"small\"");
+
+  idle = probe (fd);
+
+  pid = fork ("reader");
+  if (pid == 0)
+    stream_big ();
+  if (pid == PID_ERROR)
+    fail ("fork failed");
+  loaded = probe (fd);
+  if (wait (pid) != 0)
+    fail ("reader exited abnormally");
+  close (fd);
+
+  msg ("idle: %llu cycles per small read.", idle);
+  msg ("loaded: %llu cycles per small read.", loaded);
+}
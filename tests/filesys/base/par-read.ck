@@ -0,0 +1,22 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+my ($idle) = map (/idle: (\d+) cycles per small read/, @output);
+my ($loaded) = map (/loaded: (\d+) cycles per small read/, @output);
+fail "missing read timing\n" if !defined $idle || !defined $loaded;
+
+# A small read that waits behind the reader's whole 64-sector
+# pass costs dozens of times an idle read.  Waiting for one
+# sector at a time should stay within a small multiple.
+fail "small reads took $loaded cycles under load, $idle idle: "
+  . "reads of different files do not overlap\n"
+  if $loaded > 8 * $idle + 100000;
+pass;
@@ -47,4 +47,14 @@ void check_file (const char *file_name, const void *buf, size_t filesize);
 void compare_bytes (const void *read_data, const void *expected_data,
                     size_t size, size_t ofs, const char *file_name);
 
+/* Returns the CPU's time-stamp counter, for timing benchmarks. */
+static inline unsigned long long
+rdtsc (void)
+{
+  unsigned int lo, hi;
+
+  asm volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+  return ((unsigned long long) hi << 32) | lo;
+}
+
 #endif /* test/lib.h */
@@ -0,0 +1,83 @@
+/* Measures how much work the alarm clock does per timer tick as
+   the number of sleeping threads grows into the thousands.
+
+   Each round puts more threads to sleep until a common, distant
+   wakeup time and then times thread_awake(), the routine the
+   timer interrupt runs to wake threads, for a tick at which none
+   of them are due.  With a sleep queue ordered by wakeup time
+   this should not depend on how many threads are asleep.  At the
+   end all of the sleepers wake up together.
+
+   The .ck file works out how much the slowest call observed
+   grows per sleeping thread. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/interrupt.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+#include "intrinsic.h"
+
+#define CALL_CNT 32             /* thread_awake() calls per round. */
+
+static const int sleeper_cnts[] = {0, 100, 1000, 2000};
+
+static int64_t wake_time;
+static struct semaphore done_sema;
+
+static thread_func sleeper_thread;
+
+void
+test_alarm_many_sleepers (void)
+{
+  int sleepers = 0;
+  int round, i;
+
+  sema_init (&done_sema, 0);
+  wake_time = timer_ticks () + 60 * TIMER_FREQ;
+
+  for (round = 0; round < (int) (sizeof sleeper_cnts / sizeof *sleeper_cnts);
+       round++)
+    {
+      uint64_t worst = 0;
+
+      /* Each new thread has a higher priority than we do, so it
+         goes to sleep before thread_create() returns. */
+      for (; sleepers < sleeper_cnts[round]; sleepers++)
+        {
+          char name[sizeof "sleep -2147483648"];
+          snprintf (name, sizeof name, "sleep %d", sleepers);
+          if (thread_create (name, PRI_DEFAULT + 1, sleeper_thread, NULL)
+              == TID_ERROR)
+            fail ("could not create thread %d", sleepers);
+        }
+
+      for (i = 0; i < CALL_CNT; i++)
+        {
+          enum intr_level old_level = intr_disable ();
+          uint64_t start = rdtsc ();
+          thread_awake (timer_ticks ());
+          uint64_t cost = rdtsc () - start;
+          intr_set_level (old_level);
+
+          if (cost > worst)
+            worst = cost;
+        }
+      msg ("%d threads asleep: slowest check took %llu cycles.",
+           sleepers, worst);
+    }
+
+  msg ("Waiting for all %d sleepers to wake up...", sleepers);
+  for (i = 0; i < sleepers; i++)
+    sema_down (&done_sema);
+  msg ("All sleepers woke up.");
+}
+
+static void
+sleeper_thread (void *aux UNUSED)
+{
+  timer_sleep (wake_time - timer_ticks ());
+  sema_up (&done_sema);
+}
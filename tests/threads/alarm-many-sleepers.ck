@@ -0,0 +1,36 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+fail "not all sleepers woke up\n"
+  if !grep (/All sleepers woke up\./, @output);
+
+# Get the slowest check seen for each number of sleepers.
+local ($_);
+my (%cycles);
+foreach (@output) {
+    my ($asleep, $cost) = /(\d+) threads asleep: slowest check took (\d+) cycles\./
+      or next;
+    $cycles{$asleep} = $cost;
+}
+fail "missing measurement for $_ sleepers\n"
+  foreach grep (!defined $cycles{$_}, 0, 100, 1000, 2000);
+
+# Scanning every sleeper from the timer interrupt costs at least
+# tens of cycles per sleeper.  Looking only at the earliest wakeup
+# costs the same however many sleep, so the slowest check should
+# grow by next to nothing per sleeper.  Allow a couple of cycles
+# for emulator noise.
+my ($per_sleeper) = ($cycles{2000} - $cycles{0}) / 2000;
+fail sprintf ("per-tick check grew by %.1f cycles per sleeper "
+              . "($cycles{0} with none, $cycles{2000} with 2000)\n",
+              $per_sleeper)
+  if $per_sleeper > 2;
+pass;
@@ -0,0 +1,70 @@
+/* Checks the alarm clock with dynamic ticks (-tickless).
+
+   While nothing is runnable, the idle thread programs the timer
+   to fire only at the next wakeup, so sleeping for a second
+   should take far fewer than TIMER_FREQ timer interrupts.  The
+   skipped ticks must still be counted, so the sleepers have to
+   wake up on time and in order. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define THREAD_CNT 3
+
+static int64_t start_time;
+static struct semaphore done;
+static thread_func sleeper;
+
+void
+test_alarm_tickless (void)
+{
+  int64_t start_interrupts, elapsed, interrupts;
+  int i;
+
+  ASSERT (timer_tickless);
+
+  /* Start at the beginning of a tick. */
+  start_time = timer_ticks ();
+  while (timer_ticks () == start_time)
+    continue;
+
+  sema_init (&done, 0);
+  start_time = timer_ticks ();
+  start_interrupts = timer_interrupts ();
+  for (i = 0; i < THREAD_CNT; i++)
+    {
+      char name[16];
+      snprintf (name, sizeof name, "thread %d", i);
+      thread_create (name, PRI_DEFAULT, sleeper, (void *) (intptr_t) i);
+    }
+
+  timer_sleep (TIMER_FREQ);
+  elapsed = timer_elapsed (start_time);
+  interrupts = timer_interrupts () - start_interrupts;
+  for (i = 0; i < THREAD_CNT; i++)
+    sema_down (&done);
+
+  if (elapsed < TIMER_FREQ)
+    fail ("woke up after only %lld ticks", elapsed);
+  msg ("Main thread slept for at least %d ticks.", TIMER_FREQ);
+  if (interrupts > TIMER_FREQ / 2)
+    fail ("%lld timer interrupts in %lld ticks", interrupts, elapsed);
+  msg ("Fewer than half as many timer interrupts as ticks.");
+}
+
+/* Sleeps for (ID + 1) * 10 ticks, then reports. */
+static void
+sleeper (void *id_)
+{
+  int id = (intptr_t) id_;
+  int64_t duration = (id + 1) * 10;
+
+  timer_sleep (start_time + duration - timer_ticks ());
+  msg ("Thread %d woke up %s.", id,
+       timer_elapsed (start_time) == duration ? "on time" : "late");
+  sema_up (&done);
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(alarm-tickless) begin
+(alarm-tickless) Thread 0 woke up on time.
+(alarm-tickless) Thread 1 woke up on time.
+(alarm-tickless) Thread 2 woke up on time.
+(alarm-tickless) Main thread slept for at least 100 ticks.
+(alarm-tickless) Fewer than half as many timer interrupts as ticks.
+(alarm-tickless) end
+EOF
+pass;
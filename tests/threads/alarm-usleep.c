@@ -0,0 +1,59 @@
+/* Checks that timer_usleep() blocks with sub-tick precision.
+
+   The main thread sleeps SLEEP_CNT times for SLEEP_US
+   microseconds each, which adds up to about one timer tick.
+   Every sleep must last at least as long as asked.  If sleeps
+   were rounded up to whole ticks the total would be SLEEP_CNT
+   ticks, so it must come in well under that.  Meanwhile a
+   lower-priority thread spins, and it can only make progress if
+   the sleeper really gives up the CPU. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define SLEEP_CNT 100
+#define SLEEP_US 100
+
+static volatile bool done;
+static volatile int64_t spins;
+static thread_func spinner;
+
+void
+test_alarm_usleep (void)
+{
+  int64_t start_ticks, elapsed;
+  int early = 0;
+  int i;
+
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  thread_create ("spinner", PRI_DEFAULT - 1, spinner, NULL);
+
+  start_ticks = timer_ticks ();
+  for (i = 0; i < SLEEP_CNT; i++)
+    {
+      int64_t start = timer_clock_ns ();
+
+      timer_usleep (SLEEP_US);
+      if (timer_clock_ns () - start < SLEEP_US * 1000)
+        early++;
+    }
+  elapsed = timer_elapsed (start_ticks);
+  done = true;
+
+  msg ("%d of %d sleeps woke up early.", early, SLEEP_CNT);
+  msg ("Sleeping took %s %d ticks.",
+       elapsed < SLEEP_CNT / 5 ? "fewer than" : "at least", SLEEP_CNT / 5);
+  msg ("Spinner %s while main slept.", spins > 0 ? "ran" : "did not run");
+}
+
+static void
+spinner (void *aux UNUSED)
+{
+  while (!done)
+    spins++;
+}
@@ -0,0 +1,12 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(alarm-usleep) begin
+(alarm-usleep) 0 of 100 sleeps woke up early.
+(alarm-usleep) Sleeping took fewer than 20 ticks.
+(alarm-usleep) Spinner ran while main slept.
+(alarm-usleep) end
+EOF
+pass;
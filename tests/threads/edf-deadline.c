@@ -0,0 +1,117 @@
+/* Checks the earliest-deadline-first class.  Two periodic tasks
+   at the lowest priority are admitted, admission control refuses
+   a third task that would overload the CPU, and then the two
+   tasks run ten jobs each against two CPU-bound threads of
+   higher priority without missing a deadline. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define JOB_CNT 10
+#define HOG_CNT 2
+
+struct task
+  {
+    const char *name;
+    int64_t runtime, deadline, period;  /* Requested, in ticks. */
+    int64_t work;                       /* CPU time used per job. */
+    bool admitted;
+    int jobs;
+    int64_t misses;
+  };
+
+/* 30% and 26.7% of the CPU. */
+static struct task tasks[] =
+  {
+    {"edf-a", 3, 10, 10, 1, false, 0, 0},
+    {"edf-b", 4, 15, 20, 2, false, 0, 0},
+  };
+#define TASK_CNT ((int) (sizeof tasks / sizeof *tasks))
+
+static struct semaphore admitted, done, hogs_done;
+static volatile bool stop;
+static volatile long long hog_loops;
+
+static thread_func edf_task;
+static thread_func hog;
+
+void
+test_edf_deadline (void)
+{
+  int i;
+
+  ASSERT (!thread_mlfqs);
+
+  sema_init (&admitted, 0);
+  sema_init (&done, 0);
+  sema_init (&hogs_done, 0);
+  thread_set_priority (PRI_MAX);
+
+  /* The tasks only get to run while we are blocked. */
+  for (i = 0; i < TASK_CNT; i++)
+    thread_create (tasks[i].name, PRI_MIN, edf_task, &tasks[i]);
+  for (i = 0; i < TASK_CNT; i++)
+    sema_down (&admitted);
+  for (i = 0; i < TASK_CNT; i++)
+    msg ("%s %s.", tasks[i].name,
+         tasks[i].admitted ? "admitted" : "refused");
+
+  msg ("Admitting 40%% more %s.",
+       thread_set_deadline (4, 10, 10) ? "succeeded" : "was refused");
+  msg ("Admitting 30%% more %s.",
+       thread_set_deadline (3, 10, 10) ? "succeeded" : "was refused");
+  thread_set_deadline (0, 0, 0);
+
+  /* The hogs outrank the tasks' own priority but not their
+     class. */
+  for (i = 0; i < HOG_CNT; i++)
+    thread_create ("hog", PRI_MAX - 1, hog, NULL);
+  for (i = 0; i < TASK_CNT; i++)
+    sema_down (&done);
+  stop = true;
+  for (i = 0; i < HOG_CNT; i++)
+    sema_down (&hogs_done);
+
+  for (i = 0; i < TASK_CNT; i++)
+    msg ("%s: %d jobs, %lld deadline misses.",
+         tasks[i].name, tasks[i].jobs, tasks[i].misses);
+  if (hog_loops == 0)
+    fail ("CPU hogs never ran.");
+  msg ("CPU hogs ran between jobs.");
+}
+
+static void
+edf_task (void *task_)
+{
+  struct task *task = task_;
+  struct thread *cur = thread_current ();
+
+  task->admitted = thread_set_deadline (task->runtime, task->deadline,
+                                        task->period);
+  sema_up (&admitted);
+  if (!task->admitted)
+    return;
+
+  for (task->jobs = 0; task->jobs < JOB_CNT; task->jobs++)
+    {
+      int64_t start = cur->cpu_ticks;
+
+      while (cur->cpu_ticks - start < task->work)
+        barrier ();
+      thread_wait_period ();
+    }
+  task->misses = cur->edf_misses;
+  sema_up (&done);
+}
+
+static void
+hog (void *aux UNUSED)
+{
+  while (!stop)
+    hog_loops++;
+  sema_up (&hogs_done);
+}
@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(edf-deadline) begin
+(edf-deadline) edf-a admitted.
+(edf-deadline) edf-b admitted.
+(edf-deadline) Admitting 40% more was refused.
+(edf-deadline) Admitting 30% more succeeded.
+(edf-deadline) edf-a: 10 jobs, 0 deadline misses.
+(edf-deadline) edf-b: 10 jobs, 0 deadline misses.
+(edf-deadline) CPU hogs ran between jobs.
+(edf-deadline) end
+EOF
+pass;
@@ -0,0 +1,89 @@
+/* Checks that an EDF task whose jobs need more CPU time than its
+   budget still gets a new budget every period.  The task runs at
+   the lowest priority against two CPU-bound threads of higher
+   priority, so once a budget is spent it runs only when its next
+   job is released, without ever calling thread_wait_period() in
+   between.  Every job overruns its period, so each must count as
+   a deadline miss. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define JOB_CNT 3
+#define HOG_CNT 2
+
+/* 2 ticks every 10, for jobs of 5 ticks. */
+#define RUNTIME 2
+#define PERIOD 10
+#define WORK 5
+
+static struct semaphore admitted, done, hogs_done;
+static volatile bool stop;
+static int64_t misses;
+
+static thread_func edf_task;
+static thread_func hog;
+
+void
+test_edf_overrun (void)
+{
+  int i;
+
+  ASSERT (!thread_mlfqs);
+
+  sema_init (&admitted, 0);
+  sema_init (&done, 0);
+  sema_init (&hogs_done, 0);
+  thread_set_priority (PRI_MAX);
+
+  /* The task only gets to run while we are blocked. */
+  thread_create ("edf-task", PRI_MIN, edf_task, NULL);
+  sema_down (&admitted);
+  for (i = 0; i < HOG_CNT; i++)
+    thread_create ("hog", PRI_MAX - 1, hog, NULL);
+  sema_down (&done);
+  stop = true;
+  for (i = 0; i < HOG_CNT; i++)
+    sema_down (&hogs_done);
+
+  msg ("%d jobs done.", JOB_CNT);
+  if (misses < JOB_CNT)
+    fail ("only %lld deadline misses for %d overrunning jobs.",
+          misses, JOB_CNT);
+  msg ("Every job missed its deadline.");
+}
+
+static void
+edf_task (void *aux UNUSED)
+{
+  struct thread *cur = thread_current ();
+  int job;
+
+  if (!thread_set_deadline (RUNTIME, PERIOD, PERIOD))
+    fail ("edf-task not admitted.");
+  sema_up (&admitted);
+
+  for (job = 0; job < JOB_CNT; job++)
+    {
+      int64_t start = cur->cpu_ticks;
+
+      while (cur->cpu_ticks - start < WORK)
+        barrier ();
+      thread_wait_period ();
+    }
+  misses = cur->edf_misses;
+  thread_set_deadline (0, 0, 0);
+  sema_up (&done);
+}
+
+static void
+hog (void *aux UNUSED)
+{
+  while (!stop)
+    continue;
+  sema_up (&hogs_done);
+}
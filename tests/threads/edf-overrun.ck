@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(edf-overrun) begin
+(edf-overrun) 3 jobs done.
+(edf-overrun) Every job missed its deadline.
+(edf-overrun) end
+EOF
+pass;
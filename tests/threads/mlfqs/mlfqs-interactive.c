@@ -0,0 +1,76 @@
+/* Checks that an I/O-bound thread beats a CPU hog without any
+   manual tuning of priorities or niceness.
+
+   The "hog" thread spins for 10 seconds.  Meanwhile the
+   "interactive" thread repeatedly sleeps for 4 ticks and then
+   works for about one tick.  Because its recent_cpu stays low,
+   the interactive thread should end up with a higher priority
+   than the hog and run as soon as each of its sleeps expires. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define TEST_TICKS (10 * TIMER_FREQ)
+
+static int64_t start_time;
+static struct semaphore done;
+static int hog_priority, io_priority;
+static int wakeups, on_time;
+
+static thread_func hog_thread;
+static thread_func io_thread;
+
+void
+test_mlfqs_interactive (void)
+{
+  ASSERT (thread_mlfqs);
+
+  sema_init (&done, 0);
+  start_time = timer_ticks ();
+  msg ("Starting hog and interactive threads for 10 seconds...");
+  thread_create ("hog", PRI_DEFAULT, hog_thread, NULL);
+  thread_create ("interactive", PRI_DEFAULT, io_thread, NULL);
+  sema_down (&done);
+  sema_down (&done);
+
+  if (io_priority <= hog_priority)
+    fail ("interactive thread priority %d not above hog priority %d",
+          io_priority, hog_priority);
+  msg ("Interactive thread ended with a higher priority than the hog.");
+  msg ("Interactive thread woke on time %d of %d times.", on_time, wakeups);
+}
+
+static void
+hog_thread (void *aux UNUSED)
+{
+  while (timer_elapsed (start_time) < TEST_TICKS)
+    continue;
+  hog_priority = thread_get_priority ();
+  sema_up (&done);
+}
+
+static void
+io_thread (void *aux UNUSED)
+{
+  while (timer_elapsed (start_time) < TEST_TICKS)
+    {
+      int64_t deadline = timer_ticks () + 4;
+      int64_t now;
+
+      timer_sleep (4);
+      now = timer_ticks ();
+      wakeups++;
+      if (now == deadline)
+        on_time++;
+
+      /* Work until the next tick. */
+      while (timer_ticks () == now)
+        continue;
+    }
+  io_priority = thread_get_priority ();
+  sema_up (&done);
+}
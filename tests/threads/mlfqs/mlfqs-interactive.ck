@@ -0,0 +1,27 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+fail "interactive thread did not finish with a higher priority\n"
+  if !grep (/Interactive thread ended with a higher priority than the hog\./,
+	    @output);
+
+local ($_);
+my ($on_time, $wakeups);
+foreach (@output) {
+    ($on_time, $wakeups) = /woke on time (\d+) of (\d+) times\./ and last;
+}
+fail "missing wakeup count\n" if !defined $wakeups;
+fail "interactive thread woke only $wakeups times\n" if $wakeups < 100;
+
+# Allow a few late wakeups, e.g. around once-a-second updates.
+fail "interactive thread woke on time only $on_time of $wakeups times\n"
+  if $on_time < $wakeups * 0.9;
+pass;
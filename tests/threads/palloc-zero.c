@@ -0,0 +1,90 @@
+/* Checks the cache of zeroed pages that system_wq keeps filled:
+   a PAL_ZERO page comes back zeroed even after its last user
+   dirtied it, and the pages held in the cache are still handed
+   out once the pool runs dry, so filling the cache does not cost
+   the pool any pages. */
+
+#include <stdio.h>
+#include <string.h>
+#include "tests/threads/tests.h"
+#include "threads/palloc.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "threads/workqueue.h"
+
+#define ROUND_CNT 4
+#define PAGE_CNT 16
+
+static size_t count_free_pages (void);
+
+void
+test_palloc_zero (void)
+{
+  void *pages[PAGE_CNT];
+  int dirty = 0;
+  size_t full, empty;
+  int round, i, j;
+
+  /* Keep the workers from refilling the cache until we flush. */
+  thread_set_priority (PRI_DEFAULT + 1);
+
+  for (round = 0; round < ROUND_CNT; round++)
+    {
+      flush_workqueue (system_wq);
+      for (i = 0; i < PAGE_CNT; i++)
+        {
+          uint8_t *page = palloc_get_page (PAL_USER | PAL_ZERO);
+
+          ASSERT (page != NULL);
+          for (j = 0; j < PGSIZE; j++)
+            if (page[j] != 0)
+              {
+                dirty++;
+                break;
+              }
+          memset (page, 0xa5, PGSIZE);
+          pages[i] = page;
+        }
+      for (i = 0; i < PAGE_CNT; i++)
+        palloc_free_page (pages[i]);
+    }
+  msg ("%d of %d PAL_ZERO pages were not zeroed.",
+       dirty, ROUND_CNT * PAGE_CNT);
+
+  /* Counting drains the cache, and the refill it queues cannot
+     run before the second count. */
+  flush_workqueue (system_wq);
+  full = count_free_pages ();
+  empty = count_free_pages ();
+  msg ("Free user pages %s with the cache full and empty.",
+       full == empty ? "match" : "differ");
+}
+
+/* Allocates user pages until the pool runs dry, frees them all,
+   and returns how many there were.  Taking them one at a time
+   would rescan the pool's bitmap for each page, so they are taken
+   in runs that halve down to single pages, which come from the
+   cache once the pool is dry. */
+static size_t
+count_free_pages (void)
+{
+  void **head = NULL;
+  void **run;
+  size_t run_cnt, cnt = 0;
+
+  for (run_cnt = 64; run_cnt > 0; run_cnt /= 2)
+    while ((run = palloc_get_multiple (PAL_USER, run_cnt)) != NULL)
+      {
+        run[0] = head;
+        run[1] = (void *) run_cnt;
+        head = run;
+        cnt += run_cnt;
+      }
+  while (head != NULL)
+    {
+      run = head;
+      head = run[0];
+      palloc_free_multiple (run, (size_t) run[1]);
+    }
+  return cnt;
+}
@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(palloc-zero) begin
+(palloc-zero) 0 of 64 PAL_ZERO pages were not zeroed.
+(palloc-zero) Free user pages match with the cache full and empty.
+(palloc-zero) end
+EOF
+pass;
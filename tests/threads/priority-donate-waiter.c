@@ -0,0 +1,68 @@
+/* A thread that holds a lock while waiting on a semaphore
+   receives a donation from a higher-priority thread that wants
+   the lock.  The donation must move it ahead of the other
+   semaphore waiters, so that it is the one sema_up() wakes. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+
+static struct lock lock;
+static struct semaphore sema;
+
+static thread_func low_thread;
+static thread_func med_thread;
+static thread_func high_thread;
+
+void
+test_priority_donate_waiter (void)
+{
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  /* Make sure our priority is the default. */
+  ASSERT (thread_get_priority () == PRI_DEFAULT);
+
+  lock_init (&lock);
+  sema_init (&sema, 0);
+
+  /* Each thread runs as soon as it is created, because it has a
+     higher priority than ours. */
+  thread_create ("low", PRI_DEFAULT + 1, low_thread, NULL);
+  thread_create ("med", PRI_DEFAULT + 3, med_thread, NULL);
+  thread_create ("high", PRI_DEFAULT + 5, high_thread, NULL);
+
+  msg ("Main waking one waiter.");
+  sema_up (&sema);
+  msg ("Main waking another waiter.");
+  sema_up (&sema);
+  msg ("Main finished.");
+}
+
+static void
+low_thread (void *aux UNUSED)
+{
+  lock_acquire (&lock);
+  msg ("Thread low acquired lock, waiting on semaphore.");
+  sema_down (&sema);
+  msg ("Thread low woke up with priority %d.", thread_get_priority ());
+  lock_release (&lock);
+  msg ("Thread low finished.");
+}
+
+static void
+med_thread (void *aux UNUSED)
+{
+  sema_down (&sema);
+  msg ("Thread med woke up.");
+}
+
+static void
+high_thread (void *aux UNUSED)
+{
+  lock_acquire (&lock);
+  msg ("Thread high acquired lock.");
+  lock_release (&lock);
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(priority-donate-waiter) begin
+(priority-donate-waiter) Thread low acquired lock, waiting on semaphore.
+(priority-donate-waiter) Main waking one waiter.
+(priority-donate-waiter) Thread low woke up with priority 36.
+(priority-donate-waiter) Thread high acquired lock.
+(priority-donate-waiter) Thread low finished.
+(priority-donate-waiter) Main waking another waiter.
+(priority-donate-waiter) Thread med woke up.
+(priority-donate-waiter) Main finished.
+(priority-donate-waiter) end
+EOF
+pass;
@@ -0,0 +1,82 @@
+/* Measures the cost of sema_up() as the number of threads
+   waiting on the semaphore grows.  Sorting the waiters on every
+   release costs O(n log n); a priority heap should cost
+   O(log n), so the cost should grow only slowly.
+
+   The waiters have a spread of priorities, as they would under
+   contention between threads of different importance.  The
+   rounds quadruple the waiters each time, so with a heap each
+   round should add about the same cost as the one before; the
+   .ck file checks that the increase does not itself grow. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/interrupt.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "intrinsic.h"
+
+#define PROBE_CNT 16            /* Releases timed per round. */
+#define PRI_SPREAD 16           /* Distinct waiter priorities. */
+
+static const int waiter_cnts[] = {16, 64, 256};
+#define ROUND_CNT ((int) (sizeof waiter_cnts / sizeof *waiter_cnts))
+
+static struct semaphore sema[ROUND_CNT];
+
+static thread_func waiter_thread;
+
+void
+test_priority_sema_many (void)
+{
+  int i, round;
+
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  for (round = 0; round < ROUND_CNT; round++)
+    {
+      uint64_t best = UINT64_MAX;
+
+      /* Create the waiters without letting them run, then let
+         all of them block on the semaphore. */
+      sema_init (&sema[round], 0);
+      thread_set_priority (PRI_MAX);
+      for (i = 0; i < waiter_cnts[round]; i++)
+        {
+          char name[16];
+          snprintf (name, sizeof name, "wait %d", i);
+          thread_create (name, PRI_DEFAULT + 1 + i % PRI_SPREAD,
+                         waiter_thread, &sema[round]);
+        }
+      thread_set_priority (PRI_MIN);
+      thread_set_priority (PRI_MAX);
+
+      /* The woken threads cannot run until we lower our
+         priority, so each release sees nearly all waiters. */
+      for (i = 0; i < PROBE_CNT; i++)
+        {
+          enum intr_level old_level = intr_disable ();
+          uint64_t start = rdtsc ();
+          sema_up (&sema[round]);
+          uint64_t cost = rdtsc () - start;
+          intr_set_level (old_level);
+
+          if (cost < best)
+            best = cost;
+        }
+      msg ("%d waiters: best sema_up took %llu cycles.",
+           waiter_cnts[round], best);
+
+      /* Let the woken threads finish. */
+      thread_set_priority (PRI_MIN);
+    }
+  thread_set_priority (PRI_DEFAULT);
+}
+
+static void
+waiter_thread (void *sema_)
+{
+  sema_down (sema_);
+}
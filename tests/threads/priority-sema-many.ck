@@ -0,0 +1,34 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+# Get the cheapest release seen for each number of waiters.
+local ($_);
+my (%cycles);
+foreach (@output) {
+    my ($waiters, $cost) = /(\d+) waiters: best sema_up took (\d+) cycles\./
+      or next;
+    $cycles{$waiters} = $cost;
+}
+fail "missing measurement for $_ waiters\n"
+  foreach grep (!defined $cycles{$_}, 16, 64, 256);
+
+# Each round has four times the waiters of the one before.  With
+# O(log n) releases that adds two heap levels each time, so the
+# second increase should be about the first; sorting the waiters
+# would make it several times larger.  Allow twice the first
+# increase, plus a tenth of the base cost for emulator noise.
+my ($first) = $cycles{64} - $cycles{16};
+my ($second) = $cycles{256} - $cycles{64};
+$first = 0 if $first < 0;
+fail "release cost rose by $first cycles from 16 to 64 waiters "
+  . "but by $second from 64 to 256\n"
+  if $second > 2 * $first + $cycles{16} / 10;
+pass;
@@ -0,0 +1,101 @@
+/* Measures the cost of waking a thread as the number of ready
+   threads at the same priority grows.  Each wakeup appends the
+   woken thread behind every other ready thread of its priority,
+   which with a sorted ready list costs time proportional to the
+   number of ready threads.  With a per-priority run queue the
+   cost should stay flat.
+
+   The .ck file works out how much the cheapest wakeup observed
+   grows per ready thread. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/interrupt.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "intrinsic.h"
+
+#define PROBE_CNT 16            /* Threads woken per round. */
+#define FILLER_MAX 256          /* Most ready threads in a round. */
+#define TEST_PRI (PRI_DEFAULT + 1)
+
+static const int filler_cnts[] = {0, 16, 64, 256};
+
+static struct semaphore filler_sema;
+static struct semaphore probe_sema[PROBE_CNT];
+
+static thread_func filler_thread;
+static thread_func probe_thread;
+
+void
+test_priority_wakeup_flat (void)
+{
+  int i, round;
+
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  /* Each new thread has a higher priority than we do, so it
+     runs immediately and blocks on its semaphore. */
+  sema_init (&filler_sema, 0);
+  for (i = 0; i < FILLER_MAX; i++)
+    {
+      char name[16];
+      snprintf (name, sizeof name, "filler %d", i);
+      thread_create (name, TEST_PRI, filler_thread, NULL);
+    }
+  for (i = 0; i < PROBE_CNT; i++)
+    {
+      char name[16];
+      snprintf (name, sizeof name, "probe %d", i);
+      sema_init (&probe_sema[i], 0);
+      thread_create (name, TEST_PRI, probe_thread, &probe_sema[i]);
+    }
+
+  for (round = 0; round < (int) (sizeof filler_cnts / sizeof *filler_cnts);
+       round++)
+    {
+      uint64_t best = UINT64_MAX;
+
+      /* Make FILLER_CNTS[ROUND] threads ready without letting
+         any of them run. */
+      thread_set_priority (PRI_MAX);
+      for (i = 0; i < filler_cnts[round]; i++)
+        sema_up (&filler_sema);
+
+      for (i = 0; i < PROBE_CNT; i++)
+        {
+          enum intr_level old_level = intr_disable ();
+          uint64_t start = rdtsc ();
+          sema_up (&probe_sema[i]);
+          uint64_t cost = rdtsc () - start;
+          intr_set_level (old_level);
+
+          if (cost < best)
+            best = cost;
+        }
+      msg ("%d threads ready: best wakeup took %llu cycles.",
+           filler_cnts[round], best);
+
+      /* Let every woken thread run and block again. */
+      thread_set_priority (PRI_MIN);
+    }
+  thread_set_priority (PRI_DEFAULT);
+}
+
+static void
+filler_thread (void *aux UNUSED)
+{
+  for (;;)
+    sema_down (&filler_sema);
+}
+
+static void
+probe_thread (void *sema_)
+{
+  struct semaphore *sema = sema_;
+
+  for (;;)
+    sema_down (sema);
+}
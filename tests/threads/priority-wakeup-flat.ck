@@ -0,0 +1,32 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+# Get the cheapest wakeup seen for each number of ready threads.
+local ($_);
+my (%cycles);
+foreach (@output) {
+    my ($ready, $cost) = /(\d+) threads ready: best wakeup took (\d+) cycles\./
+      or next;
+    $cycles{$ready} = $cost;
+}
+fail "missing measurement for $_ ready threads\n"
+  foreach grep (!defined $cycles{$_}, 0, 16, 64, 256);
+
+# Queueing behind the other ready threads by walking a list costs
+# at least tens of cycles per thread passed.  A per-priority FIFO
+# does not look at them, so the cost per extra ready thread should
+# round to nothing.  Allow a few cycles for emulator noise.
+my ($per_thread) = ($cycles{256} - $cycles{0}) / 256;
+fail sprintf ("wakeup cost grew by %.1f cycles per ready thread "
+              . "($cycles{0} with none, $cycles{256} with 256)\n",
+              $per_thread)
+  if $per_thread > 4;
+pass;
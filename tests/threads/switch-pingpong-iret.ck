@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+fail "missing switch timing\n"
+  if !grep (/^\(switch-pingpong-iret\) \d+ switches in \d+ us: \d+ switches per second/,
+            @output);
+fail "test did not end\n" if !grep (/^\(switch-pingpong-iret\) end$/, @output);
+pass;
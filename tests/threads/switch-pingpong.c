@@ -0,0 +1,62 @@
+/* Measures context switch throughput.  Two threads of equal
+   priority hand control back and forth through a pair of
+   semaphores, so every sema_up() and sema_down() switches
+   threads.  The same test runs as switch-pingpong-iret with
+   -switch=iret, for comparison with the full interrupt frame
+   switch. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define ROUND_CNT 20000
+
+static struct semaphore ping, pong;
+
+static thread_func ponger;
+
+void
+test_switch_pingpong (void)
+{
+  int64_t start, elapsed;
+  int i;
+
+  sema_init (&ping, 0);
+  sema_init (&pong, 0);
+  thread_create ("pong", PRI_DEFAULT, ponger, NULL);
+
+  /* Let the other thread reach its first sema_down(). */
+  sema_down (&pong);
+
+  start = timer_clock_ns ();
+  for (i = 0; i < ROUND_CNT; i++)
+    {
+      sema_up (&ping);
+      sema_down (&pong);
+    }
+  elapsed = timer_clock_ns () - start;
+  if (elapsed <= 0)
+    elapsed = 1;
+
+  /* Each round trip is two switches. */
+  msg ("%d switches in %lld us: %lld switches per second, %lld ns each.",
+       2 * ROUND_CNT, elapsed / 1000,
+       2 * ROUND_CNT * (long long) NSEC_PER_SEC / elapsed,
+       elapsed / (2 * ROUND_CNT));
+}
+
+static void
+ponger (void *aux UNUSED)
+{
+  int i;
+
+  sema_up (&pong);
+  for (i = 0; i < ROUND_CNT; i++)
+    {
+      sema_down (&ping);
+      sema_up (&pong);
+    }
+}
@@ -0,0 +1,26 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+my ($fast) = map (/^\(switch-pingpong\) \d+ switches in \d+ us: \d+ switches per second, (\d+) ns each/,
+                  @output);
+fail "missing switch timing\n" if !defined $fast;
+fail "test did not end\n" if !grep (/^\(switch-pingpong\) end$/, @output);
+
+# Compare with the same test switching through whole interrupt
+# frames.  Saving only the callee-saved registers must not be
+# slower.
+my (@iret) = read_text_file ("$test-iret.output");
+my ($slow) = map (/^\(switch-pingpong-iret\) \d+ switches in \d+ us: \d+ switches per second, (\d+) ns each/,
+                  @iret);
+fail "missing switch-pingpong-iret timing\n" if !defined $slow;
+fail "switches took $fast ns with -switch=fast, $slow ns with -switch=iret\n"
+  if $fast > $slow;
+pass;
@@ -0,0 +1,92 @@
+/* Checks the timed waits.  sema_down_timeout() and
+   cond_wait_timeout() give up after their timeout but return
+   early when woken, and a thread whose lock_acquire_timeout()
+   expires takes back the priority it donated to the holder. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+static struct semaphore sema;
+static struct lock lock;
+static struct condition cond;
+static bool acquired;
+
+static thread_func up_later;
+static thread_func signal_later;
+static thread_func acquire_briefly;
+
+void
+test_synch_timeout (void)
+{
+  int64_t start;
+  bool success;
+
+  ASSERT (!thread_mlfqs);
+
+  /* Semaphores. */
+  sema_init (&sema, 0);
+  start = timer_ticks ();
+  success = sema_down_timeout (&sema, 5);
+  msg ("sema_down_timeout on an idle semaphore %s after %s5 ticks.",
+       success ? "succeeded" : "timed out",
+       timer_elapsed (start) >= 5 ? "at least " : "fewer than ");
+
+  thread_create ("up-later", PRI_DEFAULT, up_later, NULL);
+  start = timer_ticks ();
+  success = sema_down_timeout (&sema, 100);
+  msg ("sema_down_timeout with an up after 2 ticks %s %s.",
+       success ? "succeeded" : "timed out",
+       timer_elapsed (start) < 100 ? "early" : "late");
+
+  /* Locks.  The waiter outranks us, so it runs at once and
+     donates. */
+  lock_init (&lock);
+  lock_acquire (&lock);
+  thread_create ("waiter", PRI_DEFAULT + 10, acquire_briefly, NULL);
+  msg ("Our priority while the waiter donates: %d.", thread_get_priority ());
+  timer_sleep (10);
+  msg ("The waiter %s the lock.", acquired ? "acquired" : "timed out on");
+  msg ("Our priority after the timeout: %d.", thread_get_priority ());
+  lock_release (&lock);
+
+  /* Condition variables. */
+  cond_init (&cond);
+  lock_acquire (&lock);
+  success = cond_wait_timeout (&cond, &lock, 5);
+  msg ("cond_wait_timeout with no signal %s, lock %sheld.",
+       success ? "was signaled" : "timed out",
+       lock_held_by_current_thread (&lock) ? "" : "not ");
+  thread_create ("signal-later", PRI_DEFAULT, signal_later, NULL);
+  success = cond_wait_timeout (&cond, &lock, 100);
+  msg ("cond_wait_timeout with a signal after 2 ticks %s.",
+       success ? "was signaled" : "timed out");
+  lock_release (&lock);
+}
+
+static void
+up_later (void *aux UNUSED)
+{
+  timer_sleep (2);
+  sema_up (&sema);
+}
+
+static void
+acquire_briefly (void *aux UNUSED)
+{
+  acquired = lock_acquire_timeout (&lock, 5);
+  if (acquired)
+    lock_release (&lock);
+}
+
+static void
+signal_later (void *aux UNUSED)
+{
+  timer_sleep (2);
+  lock_acquire (&lock);
+  cond_signal (&cond, &lock);
+  lock_release (&lock);
+}
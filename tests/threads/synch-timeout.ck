@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(synch-timeout) begin
+(synch-timeout) sema_down_timeout on an idle semaphore timed out after at least 5 ticks.
+(synch-timeout) sema_down_timeout with an up after 2 ticks succeeded early.
+(synch-timeout) Our priority while the waiter donates: 41.
+(synch-timeout) The waiter timed out on the lock.
+(synch-timeout) Our priority after the timeout: 31.
+(synch-timeout) cond_wait_timeout with no signal timed out, lock held.
+(synch-timeout) cond_wait_timeout with a signal after 2 ticks was signaled.
+(synch-timeout) end
+EOF
+pass;
@@ -17,6 +17,9 @@ static const struct test tests[] =
     {"alarm-priority", test_alarm_priority},
     {"alarm-zero", test_alarm_zero},
     {"alarm-negative", test_alarm_negative},
+    {"alarm-many-sleepers", test_alarm_many_sleepers},
+    {"alarm-tickless", test_alarm_tickless},
+    {"alarm-usleep", test_alarm_usleep},
     {"priority-change", test_priority_change},
     {"priority-donate-one", test_priority_donate_one},
     {"priority-donate-multiple", test_priority_donate_multiple},
@@ -29,6 +32,16 @@ static const struct test tests[] =
     {"priority-preempt", test_priority_preempt},
     {"priority-sema", test_priority_sema},
     {"priority-condvar", test_priority_condvar},
+    {"priority-wakeup-flat", test_priority_wakeup_flat},
+    {"priority-donate-waiter", test_priority_donate_waiter},
+    {"priority-sema-many", test_priority_sema_many},
+    {"workqueue", test_workqueue},
+    {"palloc-zero", test_palloc_zero},
+    {"edf-deadline", test_edf_deadline},
+    {"edf-overrun", test_edf_overrun},
+    {"switch-pingpong", test_switch_pingpong},
+    {"switch-pingpong-iret", test_switch_pingpong},
+    {"synch-timeout", test_synch_timeout},
     {"mlfqs-load-1", test_mlfqs_load_1},
     {"mlfqs-load-60", test_mlfqs_load_60},
     {"mlfqs-load-avg", test_mlfqs_load_avg},
@@ -38,6 +51,7 @@ static const struct test tests[] =
     {"mlfqs-nice-2", test_mlfqs_nice_2},
     {"mlfqs-nice-10", test_mlfqs_nice_10},
     {"mlfqs-block", test_mlfqs_block},
+    {"mlfqs-interactive", test_mlfqs_interactive},
   };
 
 static const char *test_name;
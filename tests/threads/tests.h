@@ -11,6 +11,9 @@ extern test_func test_alarm_simultaneous;
 extern test_func test_alarm_priority;
 extern test_func test_alarm_zero;
 extern test_func test_alarm_negative;
+extern test_func test_alarm_many_sleepers;
+extern test_func test_alarm_tickless;
+extern test_func test_alarm_usleep;
 extern test_func test_priority_change;
 extern test_func test_priority_donate_one;
 extern test_func test_priority_donate_multiple;
@@ -23,6 +26,15 @@ extern test_func test_priority_fifo;
 extern test_func test_priority_preempt;
 extern test_func test_priority_sema;
 extern test_func test_priority_condvar;
+extern test_func test_priority_wakeup_flat;
+extern test_func test_priority_donate_waiter;
+extern test_func test_priority_sema_many;
+extern test_func test_workqueue;
+extern test_func test_palloc_zero;
+extern test_func test_edf_deadline;
+extern test_func test_edf_overrun;
+extern test_func test_switch_pingpong;
+extern test_func test_synch_timeout;
 extern test_func test_mlfqs_load_1;
 extern test_func test_mlfqs_load_60;
 extern test_func test_mlfqs_load_avg;
@@ -32,6 +44,7 @@ extern test_func test_mlfqs_fair_20;
 extern test_func test_mlfqs_nice_2;
 extern test_func test_mlfqs_nice_10;
 extern test_func test_mlfqs_block;
+extern test_func test_mlfqs_interactive;
 
 void msg (const char *, ...);
 void fail (const char *, ...);
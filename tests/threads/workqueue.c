@@ -0,0 +1,97 @@
+/* Checks the workqueue API: items run in the order they were
+   queued, a pending item cannot be queued twice, a pending item
+   can be canceled, flush_workqueue() waits for everything queued,
+   and delayed work runs once its timer has expired, from the
+   timer interrupt, unless canceled first. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/workqueue.h"
+#include "devices/timer.h"
+
+#define ITEM_CNT 4
+
+struct item {
+  struct work work;
+  int id;
+};
+
+static int order[ITEM_CNT];
+static int order_cnt;
+
+static int64_t delayed_ran_at;
+static bool canceled_ran;
+static struct semaphore delayed_done;
+
+static work_func record_item;
+static work_func record_delayed;
+static work_func record_canceled;
+
+void
+test_workqueue (void)
+{
+  struct workqueue *wq;
+  struct item items[ITEM_CNT];
+  struct delayed_work dwork, canceled;
+  int64_t start;
+  int i;
+
+  wq = workqueue_create ("test", 1);
+  ASSERT (wq != NULL);
+
+  /* The worker has our priority, so nothing runs until we
+     flush. */
+  for (i = 0; i < ITEM_CNT; i++)
+    {
+      items[i].id = i;
+      work_init (&items[i].work, record_item);
+      queue_work (wq, &items[i].work);
+    }
+  msg ("Queueing pending item 0 again %s.",
+       queue_work (wq, &items[0].work) ? "succeeded" : "was refused");
+  msg ("Canceling pending item 2 %s.",
+       cancel_work (&items[2].work) ? "succeeded" : "failed");
+  flush_workqueue (wq);
+  for (i = 0; i < order_cnt; i++)
+    msg ("Item %d ran.", order[i]);
+  msg ("Canceling finished item 0 %s.",
+       cancel_work (&items[0].work) ? "succeeded" : "failed");
+
+  sema_init (&delayed_done, 0);
+  delayed_work_init (&dwork, record_delayed);
+  delayed_work_init (&canceled, record_canceled);
+  start = timer_ticks ();
+  queue_delayed_work (wq, &dwork, 10);
+  queue_delayed_work (wq, &canceled, 5);
+  msg ("Canceling delayed work before it expires %s.",
+       cancel_delayed_work (&canceled) ? "succeeded" : "failed");
+  sema_down (&delayed_done);
+  flush_workqueue (wq);
+  msg ("Delayed work ran %s 10 ticks.",
+       delayed_ran_at - start >= 10 ? "after" : "before");
+  msg ("Canceled delayed work %s.", canceled_ran ? "ran" : "did not run");
+}
+
+static void
+record_item (struct work *work)
+{
+  struct item *item = work_entry (work, struct item, work);
+
+  order[order_cnt++] = item->id;
+}
+
+static void
+record_delayed (struct work *work UNUSED)
+{
+  delayed_ran_at = timer_ticks ();
+  sema_up (&delayed_done);
+}
+
+static void
+record_canceled (struct work *work UNUSED)
+{
+  canceled_ran = true;
+}
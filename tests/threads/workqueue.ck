@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(workqueue) begin
+(workqueue) Queueing pending item 0 again was refused.
+(workqueue) Canceling pending item 2 succeeded.
+(workqueue) Item 0 ran.
+(workqueue) Item 1 ran.
+(workqueue) Item 3 ran.
+(workqueue) Canceling finished item 0 failed.
+(workqueue) Canceling delayed work before it expires succeeded.
+(workqueue) Delayed work ran after 10 ticks.
+(workqueue) Canceled delayed work did not run.
+(workqueue) end
+EOF
+pass;
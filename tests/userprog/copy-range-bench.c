@@ -0,0 +1,84 @@
+/* Copies a 256 kB file twice: once the usual way, with read()
+   and write() through a 4 kB user buffer, and once with a single
+   copy_file_range() that keeps the data in the kernel.  Checks
+   both copies and reports the cycles each took. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define FILE_SIZE (256 * 1024)
+#define BUF_SIZE 4096
+
+static char buf[BUF_SIZE];
+
+/* Creates NAME, FILE_SIZE bytes long, and returns an open fd for
+   it. */
+static int
+create_file (const char *name)
+{
+  int fd;
+
+  CHECK (create (name, FILE_SIZE), "create \"%s\"", name);
+  CHECK ((fd = open (name)) > 1, "open \"%s\"", name);
+  return fd;
+}
+
+/* Checks that FD holds the pattern written to the source. */
+static void
+check_copy (int fd, const char *name)
+{
+  int ofs, i;
+
+  seek (fd, 0);
+  for (ofs = 0; ofs < FILE_SIZE; ofs += BUF_SIZE)
+    {
+      if (read (fd, buf, BUF_SIZE) != BUF_SIZE)
+        fail ("read of \"%s\" at %d failed", name, ofs);
+      for (i = 0; i < BUF_SIZE; i++)
+        if (buf[i] != (char) ((ofs + i) * 13 + (ofs + i) / 251))
+          fail ("byte %d of \"%s\" is wrong", ofs + i, name);
+    }
+}
+
+void
+test_main (void) 
+{
+  unsigned long long start, rw_cycles, range_cycles;
+  int src, dst1, dst2, ofs, i;
+
+  src = create_file ("src");
+  for (ofs = 0; ofs < FILE_SIZE; ofs += BUF_SIZE)
+    {
+      for (i = 0; i < BUF_SIZE; i++)
+        buf[i] = (ofs + i) * 13 + (ofs + i) / 251;
+      if (write (src, buf, BUF_SIZE) != BUF_SIZE)
+        fail ("write of \"src\" at %d failed", ofs);
+    }
+  dst1 = create_file ("dst1");
+  dst2 = create_file ("dst2");
+
+  seek (src, 0);
+  start = rdtsc ();
+  for (ofs = 0; ofs < FILE_SIZE; ofs += BUF_SIZE)
+    if (read (src, buf, BUF_SIZE) != BUF_SIZE
+        || write (dst1, buf, BUF_SIZE) != BUF_SIZE)
+      fail ("read/write copy at %d failed", ofs);
+  rw_cycles = rdtsc () - start;
+
+  start = rdtsc ();
+  if (copy_file_range (src, 0, dst2, 0, FILE_SIZE) != FILE_SIZE)
+    fail ("copy_file_range failed");
+  range_cycles = rdtsc () - start;
+
+  check_copy (dst1, "dst1");
+  check_copy (dst2, "dst2");
+  close (src);
+  close (dst1);
+  close (dst2);
+
+  msg ("read/write: %d syscalls, %llu cycles per kB.",
+       2 * FILE_SIZE / BUF_SIZE, rw_cycles / (FILE_SIZE / 1024));
+  msg ("copy_file_range: 1 syscall, %llu cycles per kB.",
+       range_cycles / (FILE_SIZE / 1024));
+}
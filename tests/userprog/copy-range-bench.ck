@@ -0,0 +1,27 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+my ($rw_calls, $rw) = map (/read\/write: (\d+) syscalls, (\d+) cycles per kB/,
+                           @output);
+my ($range) = map (/copy_file_range: 1 syscall, (\d+) cycles per kB/, @output);
+fail "missing read/write timing\n" if !defined $rw;
+fail "missing copy_file_range timing\n" if !defined $range;
+
+# 256 kB in 4 kB chunks, a read and a write each.
+fail "read/write copy made $rw_calls syscalls, expected 128\n"
+  if $rw_calls != 128;
+
+# Both copies do the same disk I/O; copy_file_range() saves the
+# system calls and both trips through user memory, so it must not
+# be slower, give or take timing noise.
+fail "copy_file_range took $range cycles per kB, read/write $rw\n"
+  if $range > $rw + $rw / 10;
+pass;
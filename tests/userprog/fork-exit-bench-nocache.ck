@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+fail "child did not exit cleanly\n"
+  if grep (/^child: exit/ && !/^child: exit\(0\)$/, @output);
+fail "missing spawn timing\n"
+  if !grep (/\d+ spawns: \d+ cycles per fork\+exit\+wait on average/, @output);
+pass;
@@ -0,0 +1,37 @@
+/* Measures fork+exit+wait throughput.  Each child exits at once,
+   so the cost is dominated by creating and destroying the child
+   thread.  The same program runs as fork-exit-bench-nocache with
+   the free-thread cache disabled, for comparison. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define SPAWN_CNT 64
+
+void
+test_main (void) 
+{
+  unsigned long long total = 0, best = (unsigned long long) -1;
+  int i;
+
+  for (i = 0; i < SPAWN_CNT; i++)
+    {
+      unsigned long long start = rdtsc (), cost;
+      pid_t pid = fork ("child");
+
+      if (pid == 0)
+        exit (0);
+      if (pid == PID_ERROR)
+        fail ("fork #%d failed", i);
+      if (wait (pid) != 0)
+        fail ("child #%d exited abnormally", i);
+
+      cost = rdtsc () - start;
+      total += cost;
+      if (cost < best)
+        best = cost;
+    }
+  msg ("%d spawns: %llu cycles per fork+exit+wait on average, best %llu.",
+       SPAWN_CNT, total / SPAWN_CNT, best);
+}
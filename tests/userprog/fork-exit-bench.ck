@@ -0,0 +1,29 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+fail "child did not exit cleanly\n"
+  if grep (/^child: exit/ && !/^child: exit\(0\)$/, @output);
+my ($best) = map (/\d+ spawns: \d+ cycles per fork\+exit\+wait on average, best (\d+)/,
+                  @output);
+fail "missing spawn timing\n" if !defined $best;
+
+# Compare with the same program run without the thread cache.
+# The best spawn reuses a cached thread page and fd table, so it
+# must not cost more than the best one that allocates them.
+my (@nocache) = read_text_file ("$test-nocache.output");
+my ($nocache_best)
+  = map (/\d+ spawns: \d+ cycles per fork\+exit\+wait on average, best (\d+)/,
+         @nocache);
+fail "missing fork-exit-bench-nocache timing\n" if !defined $nocache_best;
+fail "best spawn took $best cycles with the thread cache, "
+  . "$nocache_best without\n"
+  if $best > $nocache_best;
+pass;
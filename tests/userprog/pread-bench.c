@@ -0,0 +1,86 @@
+/* Compares random reads done with seek() plus read(), two system
+   calls each, against the same reads done with pread(), one
+   system call each.  Both passes visit the same offsets, and the
+   data is checked each time. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define FILE_SIZE 65536
+#define BLOCK_SIZE 512
+#define READ_CNT 1024
+
+static char buf[FILE_SIZE];
+
+/* Returns the offset of the next block to read, from a linear
+   congruential generator seeded with *SEED, so that each pass
+   visits the same offsets. */
+static off_t
+block_ofs (unsigned *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return (*seed >> 8) % (FILE_SIZE / BLOCK_SIZE) * BLOCK_SIZE;
+}
+
+/* Checks that BLOCK holds the data written at OFS. */
+static void
+check_block (const char *block, off_t ofs)
+{
+  int i;
+
+  for (i = 0; i < BLOCK_SIZE; i++)
+    if (block[i] != (char) ((ofs + i) * 7))
+      fail ("byte %d of block at %d read back wrong", i, (int) ofs);
+}
+
+void
+test_main (void) 
+{
+  char block[BLOCK_SIZE];
+  unsigned long long start, seek_cycles, pread_cycles;
+  unsigned seed;
+  int fd, i;
+
+  CHECK (create ("data", FILE_SIZE), "create \"data\"");
+  CHECK ((fd = open ("data")) > 1, "open \"data\"");
+  for (i = 0; i < FILE_SIZE; i++)
+    buf[i] = i * 7;
+  if (write (fd, buf, FILE_SIZE) != FILE_SIZE)
+    fail ("write failed");
+
+  seed = 1;
+  start = rdtsc ();
+  for (i = 0; i < READ_CNT; i++)
+    {
+      off_t ofs = block_ofs (&seed);
+
+      seek (fd, ofs);
+      if (read (fd, block, BLOCK_SIZE) != BLOCK_SIZE)
+        fail ("read #%d failed", i);
+      check_block (block, ofs);
+    }
+  seek_cycles = rdtsc () - start;
+
+  /* pread() must leave the position where the last read did. */
+  seek (fd, 100);
+  seed = 1;
+  start = rdtsc ();
+  for (i = 0; i < READ_CNT; i++)
+    {
+      off_t ofs = block_ofs (&seed);
+
+      if (pread (fd, block, BLOCK_SIZE, ofs) != BLOCK_SIZE)
+        fail ("pread #%d failed", i);
+      check_block (block, ofs);
+    }
+  pread_cycles = rdtsc () - start;
+  if (tell (fd) != 100)
+    fail ("pread moved the file position to %u", tell (fd));
+  close (fd);
+
+  msg ("seek+read: %d syscalls, %llu cycles per %d-byte read.",
+       2 * READ_CNT, seek_cycles / READ_CNT, BLOCK_SIZE);
+  msg ("pread: %d syscalls, %llu cycles per %d-byte read.",
+       READ_CNT, pread_cycles / READ_CNT, BLOCK_SIZE);
+}
@@ -0,0 +1,29 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+my ($seek_calls, $seek)
+  = map (/seek\+read: (\d+) syscalls, (\d+) cycles per \d+-byte read/, @output);
+my ($pread_calls, $pread)
+  = map (/pread: (\d+) syscalls, (\d+) cycles per \d+-byte read/, @output);
+fail "missing seek+read timing\n" if !defined $seek;
+fail "missing pread timing\n" if !defined $pread;
+
+# 1024 reads: two system calls each with seek(), one with pread().
+fail "seek+read made $seek_calls syscalls, expected 2048\n"
+  if $seek_calls != 2048;
+fail "pread made $pread_calls syscalls, expected 1024\n"
+  if $pread_calls != 1024;
+
+# Both passes read the same sectors, so pread() saves one system
+# call per read and must not be slower, give or take timing noise.
+fail "pread took $pread cycles per read, seek+read $seek\n"
+  if $pread > $seek + $seek / 10;
+pass;
@@ -0,0 +1,82 @@
+/* Measures the cost of large read and write system calls.  Each
+   call moves a 64 kB buffer, so the time spent validating the
+   user buffer, which grows with its size, shows up next to the
+   file system work.
+
+   Then isolates that overhead with reads at end of file, which
+   find no data: a 64 kB one should cost about what a 1-byte one
+   does, however the kernel checks the buffer. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define BUF_SIZE 65536
+#define ROUND_CNT 16
+
+static char buf[BUF_SIZE];
+
+/* Returns the average cycles taken by a SIZE-byte read of FD at
+   end of file. */
+static unsigned long long
+eof_read_cycles (int fd, size_t size)
+{
+  unsigned long long total = 0;
+  int i;
+
+  for (i = 0; i < ROUND_CNT; i++)
+    {
+      unsigned long long start;
+
+      seek (fd, BUF_SIZE);
+      start = rdtsc ();
+      if (read (fd, buf, size) != 0)
+        fail ("read at end of file returned data");
+      total += rdtsc () - start;
+    }
+  return total / ROUND_CNT;
+}
+
+void
+test_main (void) 
+{
+  unsigned long long write_total = 0, read_total = 0, eof_small, eof_large;
+  int fd, i;
+
+  CHECK (create ("big", BUF_SIZE), "create \"big\"");
+  CHECK ((fd = open ("big")) > 1, "open \"big\"");
+  for (i = 0; i < BUF_SIZE; i++)
+    buf[i] = i;
+
+  for (i = 0; i < ROUND_CNT; i++)
+    {
+      unsigned long long start;
+
+      seek (fd, 0);
+      start = rdtsc ();
+      if (write (fd, buf, BUF_SIZE) != BUF_SIZE)
+        fail ("write #%d failed", i);
+      write_total += rdtsc () - start;
+
+      seek (fd, 0);
+      start = rdtsc ();
+      if (read (fd, buf, BUF_SIZE) != BUF_SIZE)
+        fail ("read #%d failed", i);
+      read_total += rdtsc () - start;
+    }
+
+  for (i = 0; i < BUF_SIZE; i++)
+    if (buf[i] != (char) i)
+      fail ("byte %d read back wrong", i);
+
+  eof_small = eof_read_cycles (fd, 1);
+  eof_large = eof_read_cycles (fd, BUF_SIZE);
+  close (fd);
+
+  msg ("%d-byte write: %llu cycles on average.",
+       BUF_SIZE, write_total / ROUND_CNT);
+  msg ("%d-byte read: %llu cycles on average.",
+       BUF_SIZE, read_total / ROUND_CNT);
+  msg ("end of file: %llu cycles per 1-byte read, %llu per %d-byte read.",
+       eof_small, eof_large, BUF_SIZE);
+}
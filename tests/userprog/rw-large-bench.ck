@@ -0,0 +1,28 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+fail "missing write timing\n"
+  if !grep (/\d+-byte write: \d+ cycles on average/, @output);
+fail "missing read timing\n"
+  if !grep (/\d+-byte read: \d+ cycles on average/, @output);
+
+my ($small, $large)
+  = map (/end of file: (\d+) cycles per 1-byte read, (\d+) per \d+-byte read/,
+         @output);
+fail "missing end-of-file timing\n" if !defined $small || !defined $large;
+
+# Checking the buffer byte by byte costs a page lookup per
+# byte, tens of millions of cycles for 64 kB.  Checking it page by
+# page, or not until the copy, costs next to nothing.
+fail "$large cycles for a 64 kB read at end of file, $small for 1 byte: "
+  . "buffer checks grow with the buffer size\n"
+  if $large > 2 * $small + 100000;
+pass;
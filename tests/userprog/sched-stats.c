@@ -0,0 +1,47 @@
+/* Checks that sched_stats() reports the calling process, that
+   its CPU time was accounted, and that blocking in fork() and
+   wait() counted as voluntary context switches. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define STATS_MAX 32
+
+static struct sched_stats stats[STATS_MAX];
+
+void
+test_main (void) 
+{
+  volatile int spin;
+  int cnt, i;
+  pid_t pid;
+
+  for (spin = 0; spin < 10000000; spin++)
+    continue;
+
+  pid = fork ("child");
+  if (pid == 0)
+    exit (0);
+  CHECK (wait (pid) == 0, "wait for child");
+
+  cnt = sched_stats (NULL, 0);
+  CHECK (cnt >= 2, "sched_stats() counts live threads");
+  cnt = sched_stats (stats, STATS_MAX);
+  if (cnt > STATS_MAX)
+    cnt = STATS_MAX;
+  for (i = 0; i < cnt; i++)
+    if (!strcmp (stats[i].name, "sched-stats"))
+      break;
+  if (i >= cnt)
+    fail ("no entry for sched-stats");
+
+  if (stats[i].cpu_ticks <= 0)
+    fail ("no CPU time accounted");
+  if (stats[i].voluntary_switches < 2)
+    fail ("only %lld voluntary switches", stats[i].voluntary_switches);
+  if (stats[i].ready_ticks < 0 || stats[i].lock_ticks < 0)
+    fail ("negative wait time");
+  msg ("found own entry");
+}
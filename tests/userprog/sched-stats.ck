@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(sched-stats) begin
+child: exit(0)
+(sched-stats) wait for child
+(sched-stats) sched_stats() counts live threads
+(sched-stats) found own entry
+(sched-stats) end
+sched-stats: exit(0)
+EOF
+pass;
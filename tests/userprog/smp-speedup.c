@@ -0,0 +1,67 @@
+/* Measures how well CPU-bound processes scale across CPUs.  The
+   parent times one child that spins through a fixed amount of
+   work, then CHILD_CNT children doing the same work at once, and
+   reports the speedup CHILD_CNT * T1 / Tn.  Run with --smp=4, an
+   idle CPU steals the extra children, so given four host CPUs the
+   speedup should be well above the 1.00 a single CPU gets.  Only
+   user code runs in parallel; see the kernel lock in smp.h. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHILD_CNT 4
+#define SPIN_CNT 30000000
+
+/* Spins through SPIN_CNT rounds of xorshift and exits.  The
+   generator never reaches 0 from a nonzero seed, so the child
+   exits with 0, but the compiler cannot drop the loop. */
+static void
+spin (void)
+{
+  unsigned long long x = 88172645463325252ULL;
+  int i;
+
+  for (i = 0; i < SPIN_CNT; i++)
+    {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+    }
+  exit (x == 0);
+}
+
+/* Runs CNT spinning children at once and returns the cycles
+   until the last one has been reaped. */
+static unsigned long long
+run_children (int cnt)
+{
+  unsigned long long start = rdtsc ();
+  pid_t pids[CHILD_CNT];
+  int i;
+
+  for (i = 0; i < cnt; i++)
+    {
+      pids[i] = fork ("child");
+      if (pids[i] == 0)
+        spin ();
+      if (pids[i] == PID_ERROR)
+        fail ("fork #%d failed", i);
+    }
+  for (i = 0; i < cnt; i++)
+    if (wait (pids[i]) != 0)
+      fail ("child #%d exited abnormally", i);
+  return rdtsc () - start;
+}
+
+void
+test_main (void) 
+{
+  unsigned long long one, all, speedup;
+
+  one = run_children (1);
+  all = run_children (CHILD_CNT);
+  speedup = CHILD_CNT * one * 100 / all;
+  msg ("%d children: speedup %llu.%02llu over one child.",
+       CHILD_CNT, speedup / 100, speedup % 100);
+}
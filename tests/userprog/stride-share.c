@@ -0,0 +1,119 @@
+/* Checks that the stride scheduler divides the CPU among
+   CPU-bound processes in proportion to their tickets.  Each child
+   sets its own share, waits for a common start time, then counts
+   units of work until a common end time and reports the count as
+   its exit status.  Run with -stride. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHILD_CNT 3
+#define WINDOW_TICKS 300        /* Length of the measurement window. */
+#define TOLERANCE 5             /* Allowed error, in percentage points. */
+#define PARENT_TICKETS 10000    /* Largest share the kernel allows. */
+
+static const int child_tickets[CHILD_CNT] = { 100, 200, 300 };
+
+static struct sched_stats stats[32];
+
+/* Returns the CPU time of this process, in timer ticks. */
+static long long
+own_cpu_ticks (void)
+{
+  int cnt = sched_stats (stats, sizeof stats / sizeof *stats);
+  int i;
+
+  for (i = 0; i < cnt && i < (int) (sizeof stats / sizeof *stats); i++)
+    if (!strcmp (stats[i].name, "stride-share"))
+      return stats[i].cpu_ticks;
+  fail ("no sched_stats entry for stride-share");
+}
+
+/* Returns the number of TSC cycles in one timer tick, measured
+   while this process is the only one running. */
+static unsigned long long
+cycles_per_tick (void)
+{
+  long long start_ticks;
+  unsigned long long start;
+
+  start_ticks = own_cpu_ticks ();
+  while (own_cpu_ticks () == start_ticks)
+    continue;
+  start_ticks++;
+  start = rdtsc ();
+  while (own_cpu_ticks () < start_ticks + 10)
+    continue;
+  return (rdtsc () - start) / 10;
+}
+
+static void
+child (int tickets, unsigned long long start, unsigned long long end)
+{
+  volatile int spin;
+  int work = 0;
+
+  if (set_tickets (tickets) < 0)
+    exit (-1);
+  while (rdtsc () < start)
+    continue;
+  do
+    {
+      for (spin = 0; spin < 1000; spin++)
+        continue;
+      work++;
+    }
+  while (rdtsc () < end);
+  exit (work);
+}
+
+void
+test_main (void) 
+{
+  unsigned long long tick, start, end;
+  int work[CHILD_CNT];
+  pid_t pids[CHILD_CNT];
+  int total_work = 0, total_tickets = 0;
+  int i;
+
+  CHECK (set_tickets (0) == -1, "set_tickets(0) fails");
+  CHECK (set_tickets (PARENT_TICKETS) > 0, "set_tickets(%d)", PARENT_TICKETS);
+
+  /* Fork everyone before the window opens. */
+  tick = cycles_per_tick ();
+  start = rdtsc () + 50 * tick;
+  end = start + WINDOW_TICKS * tick;
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      pids[i] = fork ("child");
+      if (pids[i] == 0)
+        child (child_tickets[i], start, end);
+      if (pids[i] == PID_ERROR)
+        fail ("fork #%d failed", i);
+    }
+  if (rdtsc () >= start)
+    fail ("forking took longer than 50 ticks");
+
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      work[i] = wait (pids[i]);
+      if (work[i] <= 0)
+        fail ("child #%d failed", i);
+      total_work += work[i];
+      total_tickets += child_tickets[i];
+    }
+
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      int got = work[i] * 1000LL / total_work;
+      int want = child_tickets[i] * 1000 / total_tickets;
+
+      msg ("%d tickets: %d.%d%% of the CPU, expected %d.%d%%.",
+           child_tickets[i], got / 10, got % 10, want / 10, want % 10);
+      if (got < want - TOLERANCE * 10 || got > want + TOLERANCE * 10)
+        fail ("share off by more than %d points", TOLERANCE);
+    }
+  msg ("shares match tickets within %d points", TOLERANCE);
+}
@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+fail "missing share report\n"
+  if grep (/\d+ tickets: \d+\.\d% of the CPU/, @output) != 3;
+fail "shares do not match tickets\n"
+  if !grep (/shares match tickets within \d+ points/, @output);
+pass;
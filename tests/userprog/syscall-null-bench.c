@@ -0,0 +1,34 @@
+/* Measures the round-trip cost of a system call that does no
+   work: filesize() on a file descriptor that is not open, which
+   goes through the dispatch table, fetches one argument and
+   returns -1 without touching the file system. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CALL_CNT 100000
+#define BATCH_CNT 100
+
+void
+test_main (void) 
+{
+  unsigned long long total = 0, best = (unsigned long long) -1;
+  int i, j;
+
+  for (i = 0; i < BATCH_CNT; i++)
+    {
+      unsigned long long start = rdtsc (), cost;
+
+      for (j = 0; j < CALL_CNT / BATCH_CNT; j++)
+        if (filesize (-1) != -1)
+          fail ("filesize(-1) did not return -1");
+
+      cost = (rdtsc () - start) / (CALL_CNT / BATCH_CNT);
+      total += cost;
+      if (cost < best)
+        best = cost;
+    }
+  msg ("%d calls: %llu cycles per null syscall on average, best %llu.",
+       CALL_CNT, total / BATCH_CNT, best);
+}
@@ -0,0 +1,165 @@
+/* Compares small random reads done with one pread() each against
+   the same reads queued in batches on a uring, first run by
+   uring_enter() and then, in a child process, by a polling
+   kernel worker.  Every pass visits the same offsets, and the
+   data is checked each time. */
+
+#include <syscall.h>
+#include <uring.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define FILE_SIZE 65536
+#define BLOCK_SIZE 64
+#define READ_CNT 10000
+#define BATCH 32
+
+/* Where the rings are mapped: one address per process. */
+#define RING_ADDR ((void *) 0x20000000)
+#define POLL_RING_ADDR ((void *) 0x30000000)
+
+static char buf[FILE_SIZE];
+
+/* Returns the offset of the next block to read, from a linear
+   congruential generator seeded with *SEED, so that each pass
+   visits the same offsets. */
+static off_t
+block_ofs (unsigned *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return (*seed >> 8) % (FILE_SIZE / BLOCK_SIZE) * BLOCK_SIZE;
+}
+
+/* Checks that BLOCK holds the data written at OFS. */
+static void
+check_block (const char *block, off_t ofs)
+{
+  int i;
+
+  for (i = 0; i < BLOCK_SIZE; i++)
+    if (block[i] != (char) ((ofs + i) * 7))
+      fail ("byte %d of block at %d read back wrong", i, (int) ofs);
+}
+
+/* Reads READ_CNT blocks of FD through RING, BATCH at a time, and
+   returns the number of system calls made.  With POLL, the
+   kernel worker runs the requests and uring_enter() is only
+   called to wait for them. */
+static int
+ring_reads (struct uring *ring, int fd, bool poll)
+{
+  unsigned seed = 1;
+  int syscall_cnt = 0;
+  int i, j;
+
+  for (i = 0; i < READ_CNT; i += BATCH)
+    {
+      int cnt = READ_CNT - i < BATCH ? READ_CNT - i : BATCH;
+
+      for (j = 0; j < cnt; j++)
+        {
+          struct uring_sqe *sqe = &ring->sq[ring->sq_tail % URING_SQ_ENTRIES];
+
+          sqe->opcode = URING_OP_READ;
+          sqe->fd = fd;
+          sqe->buf = j * BLOCK_SIZE;
+          sqe->len = BLOCK_SIZE;
+          sqe->off = block_ofs (&seed);
+          sqe->user_data = j;
+          ring->sq_tail++;
+        }
+
+      if (!poll)
+        {
+          if (uring_enter (cnt, cnt) != cnt)
+            fail ("uring_enter at read #%d failed", i);
+          syscall_cnt++;
+        }
+      else if (ring->cq_tail - ring->cq_head < (unsigned) cnt)
+        {
+          uring_enter (0, cnt);
+          syscall_cnt++;
+        }
+      if (ring->cq_tail - ring->cq_head != (unsigned) cnt)
+        fail ("%u of %d reads completed at read #%d",
+              ring->cq_tail - ring->cq_head, cnt, i);
+
+      for (j = 0; j < cnt; j++)
+        {
+          struct uring_cqe *cqe = &ring->cq[ring->cq_head % URING_CQ_ENTRIES];
+          const struct uring_sqe *sqe = &ring->sq[(ring->sq_tail - cnt
+                                                   + cqe->user_data)
+                                                  % URING_SQ_ENTRIES];
+
+          if (cqe->res != BLOCK_SIZE)
+            fail ("read #%d returned %d", i + j, cqe->res);
+          check_block ((char *) ring->buf + sqe->buf, sqe->off);
+          ring->cq_head++;
+        }
+    }
+  return syscall_cnt;
+}
+
+void
+test_main (void) 
+{
+  char block[BLOCK_SIZE];
+  unsigned long long start, pread_cycles, ring_cycles, poll_cycles;
+  struct uring *ring;
+  unsigned seed;
+  int fd, i, syscall_cnt;
+  pid_t pid;
+
+  CHECK (create ("data", FILE_SIZE), "create \"data\"");
+  CHECK ((fd = open ("data")) > 1, "open \"data\"");
+  for (i = 0; i < FILE_SIZE; i++)
+    buf[i] = i * 7;
+  if (write (fd, buf, FILE_SIZE) != FILE_SIZE)
+    fail ("write failed");
+
+  seed = 1;
+  start = rdtsc ();
+  for (i = 0; i < READ_CNT; i++)
+    {
+      off_t ofs = block_ofs (&seed);
+
+      if (pread (fd, block, BLOCK_SIZE, ofs) != BLOCK_SIZE)
+        fail ("pread #%d failed", i);
+      check_block (block, ofs);
+    }
+  pread_cycles = rdtsc () - start;
+  msg ("pread: %d syscalls, %llu cycles per %d-byte read.",
+       READ_CNT, pread_cycles / READ_CNT, BLOCK_SIZE);
+
+  ring = uring_setup (RING_ADDR, 0);
+  if (ring != RING_ADDR)
+    fail ("uring_setup failed");
+  if (uring_setup (POLL_RING_ADDR, 0) != NULL)
+    fail ("second uring_setup succeeded");
+  start = rdtsc ();
+  syscall_cnt = ring_reads (ring, fd, false);
+  ring_cycles = rdtsc () - start;
+  msg ("uring: %d syscalls, %llu cycles per %d-byte read.",
+       syscall_cnt, ring_cycles / READ_CNT, BLOCK_SIZE);
+
+  /* A process has one ring, so the polling ring gets a fresh
+     process. */
+  pid = fork ("poller");
+  if (pid == 0)
+    {
+      ring = uring_setup (POLL_RING_ADDR, URING_SETUP_SQPOLL);
+      if (ring != POLL_RING_ADDR)
+        fail ("uring_setup with URING_SETUP_SQPOLL failed");
+      start = rdtsc ();
+      syscall_cnt = ring_reads (ring, fd, true);
+      poll_cycles = rdtsc () - start;
+      msg ("uring-sqpoll: %d syscalls, %llu cycles per %d-byte read.",
+           syscall_cnt, poll_cycles / READ_CNT, BLOCK_SIZE);
+      exit (0);
+    }
+  if (pid == PID_ERROR)
+    fail ("fork failed");
+  if (wait (pid) != 0)
+    fail ("poller exited abnormally");
+  close (fd);
+}
@@ -0,0 +1,40 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+
+common_checks ("run", @output);
+@output = get_core_output ("run", @output);
+
+my ($pread_calls, $pread)
+  = map (/pread: (\d+) syscalls, (\d+) cycles per \d+-byte read/, @output);
+my ($ring_calls, $ring)
+  = map (/uring: (\d+) syscalls, (\d+) cycles per \d+-byte read/, @output);
+my ($poll_calls, $poll)
+  = map (/uring-sqpoll: (\d+) syscalls, (\d+) cycles per \d+-byte read/,
+         @output);
+fail "missing pread timing\n" if !defined $pread;
+fail "missing uring timing\n" if !defined $ring;
+fail "missing uring-sqpoll timing\n" if !defined $poll;
+
+# 10000 reads: one pread() each, or one uring_enter() per batch of
+# 32.  The polling worker needs uring_enter() only to wait, so at
+# most once per batch.
+fail "pread made $pread_calls syscalls, expected 10000\n"
+  if $pread_calls != 10000;
+fail "uring made $ring_calls syscalls, expected 313\n"
+  if $ring_calls != 313;
+fail "uring-sqpoll made $poll_calls syscalls, more than 313\n"
+  if $poll_calls > 313;
+
+# Every pass reads the same sectors, so batching must not be
+# slower than pread(), give or take timing noise.  The polling
+# pass also pays for switching to the worker and back.
+fail "uring took $ring cycles per read, pread $pread\n"
+  if $ring > $pread + $pread / 10;
+fail "uring-sqpoll took $poll cycles per read, pread $pread\n"
+  if $poll > 2 * $pread;
+pass;
@@ -0,0 +1,58 @@
+/* Writes a header and a payload with one writev(), including an
+   empty segment, reads them back with one readv() into
+   differently split buffers, and checks the result. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static const char header[] = "HEADER:";
+
+void
+test_main (void) 
+{
+  char hbuf[sizeof header - 1];
+  char pbuf[sizeof sample - 1];
+  char console[] = "writev to stdout\n";
+  struct iovec out[3], in[2];
+  int handle, byte_cnt;
+  size_t total = sizeof header - 1 + sizeof sample - 1;
+
+  CHECK (create ("test.txt", 0), "create \"test.txt\"");
+  CHECK ((handle = open ("test.txt")) > 1, "open \"test.txt\"");
+
+  out[0].iov_base = (void *) header;
+  out[0].iov_len = sizeof header - 1;
+  out[1].iov_base = NULL;
+  out[1].iov_len = 0;
+  out[2].iov_base = (void *) sample;
+  out[2].iov_len = sizeof sample - 1;
+  byte_cnt = writev (handle, out, 3);
+  if ((size_t) byte_cnt != total)
+    fail ("writev() returned %d instead of %zu", byte_cnt, total);
+
+  /* Split the read differently from the write. */
+  seek (handle, 0);
+  in[0].iov_base = hbuf;
+  in[0].iov_len = sizeof hbuf;
+  in[1].iov_base = pbuf;
+  in[1].iov_len = sizeof pbuf;
+  byte_cnt = readv (handle, in, 2);
+  if ((size_t) byte_cnt != total)
+    fail ("readv() returned %d instead of %zu", byte_cnt, total);
+  if (memcmp (hbuf, header, sizeof hbuf))
+    fail ("header read back wrong");
+  if (memcmp (pbuf, sample, sizeof pbuf))
+    fail ("payload read back wrong");
+  msg ("read back %zu bytes", total);
+  close (handle);
+
+  out[0].iov_base = console;
+  out[0].iov_len = 7;
+  out[1].iov_base = console + 7;
+  out[1].iov_len = sizeof console - 1 - 7;
+  writev (STDOUT_FILENO, out, 2);
+}
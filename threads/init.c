@@ -19,8 +19,12 @@
 #include "threads/malloc.h"
 #include "threads/mmu.h"
 #include "threads/palloc.h"
+#include "threads/profile.h"
 #include "threads/pte.h"
+#include "threads/smp.h"
 #include "threads/thread.h"
+#include "threads/trace.h"
+#include "threads/workqueue.h"
 #ifdef USERPROG
 #include "userprog/process.h"
 #include "userprog/exception.h"
@@ -88,6 +92,8 @@ main (void) {
 	mem_end = palloc_init ();
 	malloc_init ();
 	paging_init (mem_end);
+	trace_init ();
+	profile_init ();
 
 #ifdef USERPROG
 	tss_init ();
@@ -107,6 +113,8 @@ main (void) {
 	thread_start ();
 	serial_init_queue ();
 	timer_calibrate ();
+	workqueue_init ();
+	smp_init ();
 
 #ifdef FILESYS
 	/* Initialize file system. */
@@ -222,6 +230,33 @@ parse_options (char **argv) {
 			random_init (atoi (value));
 		else if (!strcmp (name, "-mlfqs"))
 			thread_mlfqs = true;
+		else if (!strcmp (name, "-stride"))
+			thread_stride = true;
+		else if (!strcmp (name, "-tickless"))
+			timer_tickless = true;
+		else if (!strcmp (name, "-trace"))
+			trace_enabled = true;
+		else if (!strcmp (name, "-o")) {
+			/* Accept both `-o profile' and `-o=profile'. */
+			if (value == NULL && argv[1] != NULL)
+				value = *++argv;
+			if (value != NULL && !strcmp (value, "profile"))
+				profile_enabled = true;
+			else
+				PANIC ("unknown output `%s' for -o (use -h for help)",
+						value != NULL ? value : "");
+		}
+		else if (!strcmp (name, "-profile-hz"))
+			profile_hz = atoi (value);
+		else if (!strcmp (name, "-thread-cache"))
+			thread_cache_max = atoi (value);
+		else if (!strcmp (name, "-switch")) {
+			if (value != NULL && !strcmp (value, "iret"))
+				thread_iret_switch = true;
+			else if (value == NULL || strcmp (value, "fast"))
+				PANIC ("unknown switch method `%s' (use -h for help)",
+						value != NULL ? value : "");
+		}
 #ifdef USERPROG
 		else if (!strcmp (name, "-ul"))
 			user_page_limit = atoi (value);
@@ -232,6 +267,19 @@ parse_options (char **argv) {
 			PANIC ("unknown option `%s' (use -h for help)", name);
 	}
 
+	if (thread_mlfqs && thread_stride)
+		PANIC ("-mlfqs and -stride cannot be used together");
+
+	/* Both dump to the start of the scratch disk. */
+	if (trace_enabled && profile_enabled)
+		PANIC ("-trace and -o profile cannot be used together");
+#ifndef FILESYS
+	/* Without the disk driver there is nowhere to dump to, so
+	   recording would only waste memory. */
+	if (trace_enabled || profile_enabled)
+		PANIC ("-trace and -o profile need a kernel built with FILESYS");
+#endif
+
 	return argv;
 }
 
@@ -327,6 +375,16 @@ usage (void) {
 			"  -f                 Format file system disk during startup.\n"
 			"  -rs=SEED           Set random number seed to SEED.\n"
 			"  -mlfqs             Use multi-level feedback queue scheduler.\n"
+			"  -stride            Use proportional-share stride scheduler.\n"
+			"  -tickless          Stop the periodic timer tick while idle.\n"
+#ifdef FILESYS
+			"  -trace             Dump scheduler events to scratch disk.\n"
+			"  -o profile         Dump CPU usage samples to scratch disk.\n"
+			"  -profile-hz=N      Take N samples per second (default 100).\n"
+#endif
+			"  -thread-cache=N    Keep up to N dead threads for reuse.\n"
+			"  -switch=fast|iret  Switch threads by callee-saved registers\n"
+			"                     (default) or by full interrupt frame.\n"
 #ifdef USERPROG
 			"  -ul=COUNT          Limit user memory to COUNT pages.\n"
 #endif
@@ -342,10 +400,13 @@ power_off (void) {
 #ifdef FILESYS
 	filesys_done ();
 #endif
+	trace_dump ();
+	profile_dump ();
 
 	print_stats ();
 
 	printf ("Powering off...\n");
+	serial_flush ();
 	outw (0x604, 0x2000);               /* Poweroff command for qemu */
 	for (;;);
 }
@@ -363,4 +424,7 @@ print_stats (void) {
 #ifdef USERPROG
 	exception_print_stats ();
 #endif
+#ifdef LOCKSTAT
+	lockstat_print ();
+#endif
 }
@@ -8,6 +8,7 @@
 #include "threads/io.h"
 #include "threads/thread.h"
 #include "threads/mmu.h"
+#include "threads/smp.h"
 #include "threads/vaddr.h"
 #include "devices/timer.h"
 #include "intrinsic.h"
@@ -121,9 +122,20 @@ static const char *intr_names[INTR_CNT];
    외부 인터럽트는 타이머와 같은 CPU 외부의 장치에 의해 생성되는 인터럽트입니다. 
    외부 인터럽트는 인터럽트가 꺼진 상태에서 실행되므로 네스트가 발생하지 않으며 
    사전에 차단되지도 않습니다. 외부 인터럽트 핸들러는 인터럽트가 반환되기 직전에 
-   intr_yield_on_return()을 호출하여 새 프로세스를 예약하도록 요청할 수도 있지만 절전 모드가 아닐 수도 있다.*/
-static bool in_external_intr;   /* Are we processing an external interrupt? */
-static bool yield_on_return;    /* Should we yield on interrupt return? */
+   intr_yield_on_return()을 호출하여 새 프로세스를 예약하도록 요청할 수도 있지만 절전 모드가 아닐 수도 있다.
+
+   Each CPU takes its own external interrupts: the PIC's go to
+   the boot processor, and the local APIC raises the rest on
+   every CPU. */
+static bool in_external_intr[CPU_MAX];  /* Are we processing an external interrupt? */
+static bool yield_on_return[CPU_MAX];   /* Should we yield on interrupt return? */
+
+/* Returns true if VEC_NO is an external interrupt: one of the
+   PIC's, or one of the local APIC's. */
+static inline bool
+is_external (uint64_t vec_no) {
+	return (vec_no >= 0x20 && vec_no < 0x30) || vec_no >= LAPIC_TIMER_VEC;
+}
 
 /* Programmable Interrupt Controller helpers. */
 static void pic_init (void);
@@ -227,6 +239,16 @@ intr_init (void) {
 	intr_names[19] = "#XF SIMD Floating-Point Exception";
 }
 
+/* Loads the IDT built by intr_init(), and the TSS, on an
+   application processor. */
+void
+intr_init_cpu (void) {
+#ifdef USERPROG
+	ltr (SEL_TSS);
+#endif
+	lidt (&idt_desc);
+}
+
 /* Registers interrupt VEC_NO to invoke HANDLER with descriptor
    privilege level DPL.  Names the interrupt NAME for debugging
    purposes.  The interrupt handler will be invoked with
@@ -257,13 +279,14 @@ register_handler (uint8_t vec_no, int dpl, enum intr_level level,
 
 
 
-/* Registers external interrupt VEC_NO to invoke HANDLER, which
-   is named NAME for debugging purposes.  The handler will
-   execute with interrupts disabled. */
+/* Registers external interrupt VEC_NO, a PIC or local APIC
+   vector, to invoke HANDLER, which is named NAME for debugging
+   purposes.  The handler will execute with interrupts
+   disabled. */
 void
 intr_register_ext (uint8_t vec_no, intr_handler_func *handler,
 		const char *name) {
-	ASSERT (vec_no >= 0x20 && vec_no <= 0x2f);
+	ASSERT (is_external (vec_no));
 	register_handler (vec_no, 0, INTR_OFF, handler, name);
 }
 
@@ -284,7 +307,7 @@ void
 intr_register_int (uint8_t vec_no, int dpl, enum intr_level level,
 		intr_handler_func *handler, const char *name)
 {
-	ASSERT (vec_no < 0x20 || vec_no > 0x2f);
+	ASSERT (!is_external (vec_no));
 	register_handler (vec_no, dpl, level, handler, name);
 }
 /*
@@ -304,7 +327,7 @@ intr_register_int (uint8_t vec_no, int dpl, enum intr_level level,
    and false at all other times. */
 bool
 intr_context (void) {
-	return in_external_intr;
+	return in_external_intr[cpu_id ()];
 }
 
 /* During processing of an external interrupt, directs the
@@ -314,7 +337,7 @@ intr_context (void) {
 void
 intr_yield_on_return (void) {
 	ASSERT (intr_context ());
-	yield_on_return = true;
+	yield_on_return[cpu_id ()] = true;
 }
 
 /* 8259A Programmable Interrupt Controller. */
@@ -380,25 +403,35 @@ void
 intr_handler (struct intr_frame *frame) {
 	bool external;
 	intr_handler_func *handler;
+	enum intr_level old_level;
+
+	/* Enter the kernel, unless this CPU was already in it.  See
+	   the comment at the top of smp.h. */
+	old_level = intr_disable ();
+	if (!kernel_lock_held ())
+		kernel_lock_acquire ();
+	intr_set_level (old_level);
 
 	/* External interrupts are special.
 	   We only handle one at a time (so interrupts must be off)
-	   and they need to be acknowledged on the PIC (see below).
+	   and they need to be acknowledged on the PIC or the local
+	   APIC (see below).
 	   An external interrupt handler cannot sleep. */
-	external = frame->vec_no >= 0x20 && frame->vec_no < 0x30;
+	external = is_external (frame->vec_no);
 	if (external) {
 		ASSERT (intr_get_level () == INTR_OFF);
 		ASSERT (!intr_context ());
 
-		in_external_intr = true;
-		yield_on_return = false;
+		in_external_intr[cpu_id ()] = true;
+		yield_on_return[cpu_id ()] = false;
 	}
 
 	/* Invoke the interrupt's handler. */
 	handler = intr_handlers[frame->vec_no];
 	if (handler != NULL)
 		handler (frame);
-	else if (frame->vec_no == 0x27 || frame->vec_no == 0x2f) {
+	else if (frame->vec_no == 0x27 || frame->vec_no == 0x2f
+			|| frame->vec_no == LAPIC_SPURIOUS_VEC) {
 		/* There is no handler, but this interrupt can trigger
 		   spuriously due to a hardware fault or hardware race
 		   condition.  Ignore it. */
@@ -414,12 +447,22 @@ intr_handler (struct intr_frame *frame) {
 		ASSERT (intr_get_level () == INTR_OFF);
 		ASSERT (intr_context ());
 
-		in_external_intr = false;
-		pic_end_of_interrupt (frame->vec_no);
+		in_external_intr[cpu_id ()] = false;
+		if (frame->vec_no < 0x30)
+			pic_end_of_interrupt (frame->vec_no);
+		else if (frame->vec_no != LAPIC_SPURIOUS_VEC)
+			lapic_eoi ();
 
-		if (yield_on_return)
+		if (yield_on_return[cpu_id ()])
 			thread_yield ();
 	}
+
+	/* Leave the kernel when returning to user mode.  The iretq
+	   in intr_exit turns interrupts back on. */
+	if ((frame->cs & 3) == 3) {
+		intr_disable ();
+		kernel_lock_release ();
+	}
 }
 
 /* Dumps interrupt frame F to the console, for debugging. */
@@ -11,6 +11,7 @@
 #include "threads/loader.h"
 #include "threads/synch.h"
 #include "threads/vaddr.h"
+#include "threads/workqueue.h"
 
 /* Page allocator.  Hands out memory in page-size (or
    page-multiple) chunks.  See malloc.h for an allocator that
@@ -26,11 +27,24 @@
    half to the user pool.  That should be huge overkill for the
    kernel pool, but that's just fine for demonstration purposes. */
 /* 페이지 할당자 */
+
+/* Number of zeroed pages each pool keeps ready. */
+#define ZERO_CACHE_PAGES 8
+
 /* A memory pool. */
 struct pool {
 	struct lock lock;               /* Mutual exclusion. */
 	struct bitmap *used_map;        /* Bitmap of free pages. */
 	uint8_t *base;                  /* Base of pool. */
+
+	/* Single pages taken from the pool and zeroed ahead of time,
+	   so that a PAL_ZERO request need not clear one on the spot.
+	   ZERO_REFILL runs on system_wq to top the cache back up after
+	   palloc_get_multiple() takes from it. */
+	struct spinlock zero_lock;      /* Guards the two members below. */
+	void *zero_pages[ZERO_CACHE_PAGES];
+	int zero_cnt;
+	struct work zero_refill;
 };
 
 /* Two pools: one for kernel data, one for user pages. */
@@ -42,6 +56,9 @@ static void
 init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end);
 
 static bool page_from_pool (const struct pool *, void *page);
+static void *pool_take (struct pool *, size_t page_cnt);
+static void *zero_cache_get (struct pool *);
+static work_func zero_cache_refill;
 
 /* multiboot info */
 struct multiboot_info {
@@ -271,16 +288,22 @@ palloc_init (void) {
 void *
 palloc_get_multiple (enum palloc_flags flags, size_t page_cnt) {
 	struct pool *pool = flags & PAL_USER ? &user_pool : &kernel_pool;	
-
-	lock_acquire (&pool->lock);
-	size_t page_idx = bitmap_scan_and_flip (pool->used_map, 0, page_cnt, false);
-	lock_release (&pool->lock);
-	void *pages;
-
-	if (page_idx != BITMAP_ERROR)
-		pages = pool->base + PGSIZE * page_idx;
-	else
-		pages = NULL;
+	void *pages = NULL;
+
+	/* A single zeroed page comes from the cache if it has one. */
+	if (page_cnt == 1 && (flags & PAL_ZERO))
+		pages = zero_cache_get (pool);
+	if (pages != NULL)
+		return pages;
+
+	pages = pool_take (pool, page_cnt);
+	if (pages == NULL && page_cnt == 1) {
+		/* The pool ran dry, but the cache may still hold pages
+		   taken from it. */
+		pages = zero_cache_get (pool);
+		if (pages != NULL)
+			return pages;
+	}
 
 	if (pages) {
 		if (flags & PAL_ZERO)
@@ -351,6 +374,9 @@ init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end) {
 	lock_init(&p->lock);
 	p->used_map = bitmap_create_in_buf (pgcnt, *bm_base, bm_pages);
 	p->base = (void *) start;
+	spinlock_init (&p->zero_lock);
+	p->zero_cnt = 0;
+	work_init (&p->zero_refill, zero_cache_refill);
 
 	// Mark all to unusable.
 	bitmap_set_all(p->used_map, true);
@@ -367,3 +393,71 @@ page_from_pool (const struct pool *pool, void *page) {
 	size_t end_page = start_page + bitmap_size (pool->used_map);
 	return page_no >= start_page && page_no < end_page;
 }
+
+/* Marks PAGE_CNT contiguous free pages of POOL used and returns
+   the first, or returns a null pointer if there is no such run. */
+static void *
+pool_take (struct pool *pool, size_t page_cnt) {
+	size_t page_idx;
+
+	lock_acquire (&pool->lock);
+	page_idx = bitmap_scan_and_flip (pool->used_map, 0, page_cnt, false);
+	lock_release (&pool->lock);
+
+	return page_idx != BITMAP_ERROR ? pool->base + PGSIZE * page_idx : NULL;
+}
+
+/* Takes a zeroed page from POOL's cache and queues a refill, or
+   returns a null pointer if the cache is empty.  Before
+   workqueue_init() there is no one to refill it, so it stays
+   empty. */
+static void *
+zero_cache_get (struct pool *pool) {
+	void *page = NULL;
+
+	spinlock_acquire (&pool->zero_lock);
+	if (pool->zero_cnt > 0)
+		page = pool->zero_pages[--pool->zero_cnt];
+	spinlock_release (&pool->zero_lock);
+
+	if (system_wq != NULL)
+		queue_work (system_wq, &pool->zero_refill);
+	return page;
+}
+
+/* Fills the zeroed-page cache of the pool that WORK belongs to,
+   stopping early if the pool runs dry. */
+static void
+zero_cache_refill (struct work *work) {
+	struct pool *pool = work_entry (work, struct pool, zero_refill);
+
+	for (;;) {
+		void *page;
+		bool full;
+
+		spinlock_acquire (&pool->zero_lock);
+		full = pool->zero_cnt >= ZERO_CACHE_PAGES;
+		spinlock_release (&pool->zero_lock);
+		if (full)
+			return;
+
+		page = pool_take (pool, 1);
+		if (page == NULL)
+			return;
+		memset (page, 0, PGSIZE);
+
+		spinlock_acquire (&pool->zero_lock);
+		if (pool->zero_cnt < ZERO_CACHE_PAGES) {
+			pool->zero_pages[pool->zero_cnt++] = page;
+			page = NULL;
+		}
+		spinlock_release (&pool->zero_lock);
+
+		/* Only this work fills the cache, but a second worker may
+		   have been running it too. */
+		if (page != NULL) {
+			palloc_free_page (page);
+			return;
+		}
+	}
+}
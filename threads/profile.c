@@ -0,0 +1,258 @@
+#include "threads/profile.h"
+#include <debug.h>
+#include <stdio.h>
+#include <string.h>
+#include "devices/timer.h"
+#include "threads/interrupt.h"
+#include "threads/palloc.h"
+#include "threads/smp.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#ifdef USERPROG
+#include "threads/mmu.h"
+#endif
+#ifdef FILESYS
+#include "devices/disk.h"
+#endif
+
+/* Size of each CPU's ring.  Every CPU samples its own timer
+   tick into its own ring, so sampling needs no lock. */
+#define PROFILE_PAGES 128
+#define PROFILE_SAMPLE_CNT (PROFILE_PAGES * PGSIZE / sizeof (struct profile_sample))
+
+/* Header written to the first sector of the scratch disk.  The
+   samples follow starting at the next sector, one CPU's after
+   another, each CPU's oldest first. */
+struct profile_header {
+	char magic[8];              /* "PINPROF\0". */
+	uint32_t version;           /* PROFILE_VERSION. */
+	uint32_t sample_size;       /* sizeof (struct profile_sample). */
+	uint64_t sample_cnt;        /* Number of samples that follow. */
+	uint64_t dropped;           /* Older samples overwritten in the ring. */
+	uint32_t hz;                /* Samples per second. */
+};
+#define PROFILE_VERSION 2
+
+bool profile_enabled;
+int profile_hz = TIMER_FREQ;
+
+static int ticks_per_sample;            /* Timer ticks between samples. */
+
+static bool alloc_ring (struct cpu *);
+
+/* Allocates the boot processor's sample ring if profiling was
+   requested with `-o profile'.  Must be called after
+   palloc_init(). */
+void
+profile_init (void) {
+	if (!profile_enabled)
+		return;
+
+	if (profile_hz <= 0 || profile_hz > TIMER_FREQ)
+		profile_hz = TIMER_FREQ;
+	ticks_per_sample = TIMER_FREQ / profile_hz;
+	profile_hz = TIMER_FREQ / ticks_per_sample;
+
+	if (!alloc_ring (&cpus[0]))
+		profile_enabled = false;
+}
+
+/* Allocates the running AP's sample ring, if profiling is on.
+   Called by ap_main().  An AP without a ring just takes no
+   samples. */
+void
+profile_init_cpu (void) {
+	if (profile_enabled)
+		alloc_ring (cpu_current ());
+}
+
+/* Allocates C's sample ring and returns true, or returns false
+   if memory runs out. */
+static bool
+alloc_ring (struct cpu *c) {
+	c->prof_ring = palloc_get_multiple (0, PROFILE_PAGES);
+	if (c->prof_ring == NULL) {
+		printf ("profile: cannot allocate %d pages, CPU %d not sampled\n",
+				PROFILE_PAGES, c->id);
+		return false;
+	}
+	c->prof_head = 0;
+	c->prof_countdown = ticks_per_sample;
+	return true;
+}
+
+/* Returns the 8-byte word at user address UADDR in the current
+   process, or 0 if it is not mapped.  Does not fault. */
+static uint64_t
+peek_user (uintptr_t uaddr) {
+#ifdef USERPROG
+	uint64_t *pml4 = thread_current ()->pml4;
+	uint8_t *kpage;
+
+	if (pml4 == NULL || !is_user_vaddr (uaddr) || uaddr % sizeof (uint64_t))
+		return 0;
+	kpage = pml4_get_page (pml4, (void *) pg_round_down (uaddr));
+	if (kpage == NULL)
+		return 0;
+	return *(uint64_t *) (kpage + pg_ofs (uaddr));
+#else
+	(void) uaddr;
+	return 0;
+#endif
+}
+
+/* Returns the 8-byte word at kernel address KADDR if it lies in
+   the current thread's stack page, otherwise 0. */
+static uint64_t
+peek_kernel (uintptr_t kaddr) {
+	uintptr_t page = (uintptr_t) thread_current ();
+
+	if (kaddr < page + sizeof (struct thread) || kaddr + sizeof (uint64_t)
+			> page + PGSIZE || kaddr % sizeof (uint64_t))
+		return 0;
+	return *(uint64_t *) kaddr;
+}
+
+/* Takes a sample of the context that timer interrupt frame F
+   interrupted, if one is due on the running CPU.  Called on
+   every tick, by the timer interrupt handler on the boot
+   processor and by the local APIC timer's on the others. */
+void
+profile_sample (const struct intr_frame *f) {
+	struct cpu *c = cpu_current ();
+	struct profile_sample *s;
+	struct thread *t;
+	uint64_t (*peek) (uintptr_t);
+	uintptr_t fp;
+
+	if (c->prof_ring == NULL || --c->prof_countdown > 0)
+		return;
+	c->prof_countdown = ticks_per_sample;
+
+	ASSERT (intr_context ());
+	t = thread_current ();
+	s = &c->prof_ring[c->prof_head++ % PROFILE_SAMPLE_CNT];
+	s->tid = t->tid;
+	s->cpl = f->cs & 3;
+	s->cpu = c->id;
+	s->pad = 0;
+	memset (s->name, 0, sizeof s->name);
+	strlcpy (s->name, t->name, sizeof s->name);
+
+	/* Walk the frame-pointer chain.  Each frame holds the caller's
+	   frame pointer followed by the return address. */
+	peek = s->cpl == 0 ? peek_kernel : peek_user;
+	s->pc[0] = f->rip;
+	s->depth = 1;
+	for (fp = f->R.rbp; s->depth < PROFILE_DEPTH; ) {
+		uintptr_t ret = peek (fp + sizeof (uint64_t));
+		uintptr_t next = peek (fp);
+
+		if (ret == 0)
+			break;
+		s->pc[s->depth++] = ret;
+		if (next <= fp)
+			break;
+		fp = next;
+	}
+	memset (&s->pc[s->depth], 0,
+			(PROFILE_DEPTH - s->depth) * sizeof s->pc[0]);
+}
+
+/* Writes every CPU's ring to the scratch disk, header first.
+   Sampling stops for good, so that the dump is a consistent
+   snapshot.  The other CPUs sample only while holding the kernel
+   lock, which the caller holds, so none is midway through a
+   sample. */
+void
+profile_dump (void) {
+#ifdef FILESYS
+	const size_t per_sector = DISK_SECTOR_SIZE / sizeof (struct profile_sample);
+	struct profile_sample *rings[CPU_MAX];
+	uint64_t heads[CPU_MAX], cnts[CPU_MAX];
+	uint64_t cnt = 0, dropped = 0, fit, i;
+	struct profile_sample *out;
+	struct profile_header *h;
+	struct disk *scratch;
+	uint8_t *buffer;
+	disk_sector_t sector, sectors;
+	enum intr_level old_level;
+	int ncpu, c;
+	size_t j;
+
+	if (!profile_enabled)
+		return;
+	if (intr_get_level () == INTR_OFF) {
+		/* E.g. powering off after a panic: the disk driver needs
+		   interrupts. */
+		printf ("profile: interrupts off, samples discarded\n");
+		return;
+	}
+
+	old_level = intr_disable ();
+	profile_enabled = false;
+	ncpu = cpu_cnt;
+	for (c = 0; c < ncpu; c++) {
+		rings[c] = cpus[c].prof_ring;
+		heads[c] = cpus[c].prof_head;
+		cpus[c].prof_ring = NULL;
+	}
+	intr_set_level (old_level);
+
+	for (c = 0; c < ncpu; c++) {
+		cnts[c] = rings[c] == NULL ? 0
+			: heads[c] < PROFILE_SAMPLE_CNT ? heads[c] : PROFILE_SAMPLE_CNT;
+		cnt += cnts[c];
+	}
+
+	scratch = disk_get (1, 0);
+	if (scratch == NULL) {
+		printf ("profile: no scratch disk, %llu samples discarded\n", cnt);
+		return;
+	}
+
+	/* Only write whole samples, as many as fit, giving each CPU
+	   the same share if they do not all fit. */
+	sectors = disk_size (scratch);
+	if (sectors == 0)
+		return;
+	fit = (sectors - 1) * per_sector;
+	if (cnt > fit)
+		for (cnt = 0, c = 0; c < ncpu; c++) {
+			if (cnts[c] > fit / ncpu)
+				cnts[c] = fit / ncpu;
+			cnt += cnts[c];
+		}
+	for (c = 0; c < ncpu; c++)
+		dropped += heads[c] - cnts[c];
+
+	buffer = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+	h = (struct profile_header *) buffer;
+	memcpy (h->magic, "PINPROF", sizeof h->magic);
+	h->version = PROFILE_VERSION;
+	h->sample_size = sizeof *out;
+	h->sample_cnt = cnt;
+	h->dropped = dropped;
+	h->hz = profile_hz;
+	disk_write (scratch, 0, buffer);
+
+	out = (struct profile_sample *) buffer;
+	memset (buffer, 0, DISK_SECTOR_SIZE);
+	sector = 1;
+	j = 0;
+	for (c = 0; c < ncpu; c++)
+		for (i = heads[c] - cnts[c]; i < heads[c]; i++) {
+			out[j++] = rings[c][i % PROFILE_SAMPLE_CNT];
+			if (j == per_sector) {
+				disk_write (scratch, sector++, buffer);
+				memset (buffer, 0, DISK_SECTOR_SIZE);
+				j = 0;
+			}
+		}
+	if (j > 0)
+		disk_write (scratch, sector, buffer);
+	palloc_free_page (buffer);
+	printf ("profile: %llu samples written to scratch disk, %llu dropped\n",
+			cnt, dropped);
+#endif
+}
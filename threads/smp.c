@@ -0,0 +1,486 @@
+#include "threads/smp.h"
+#include <debug.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/init.h"
+#include "threads/interrupt.h"
+#include "threads/loader.h"
+#include "threads/mmu.h"
+#include "threads/profile.h"
+#include "threads/pte.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "devices/timer.h"
+#include "intrinsic.h"
+#ifdef USERPROG
+#include "userprog/gdt.h"
+#include "userprog/syscall.h"
+#include "userprog/tss.h"
+#endif
+
+/* See [MP] for the MP configuration table and [IA32-v3a]
+   chapter 10 "Advanced Programmable Interrupt Controller (APIC)"
+   for the local APIC. */
+
+/* MP floating pointer structure.  The BIOS leaves it on a 16-byte
+   boundary in one of the areas mp_search() looks through. */
+struct mp {
+	uint8_t signature[4];           /* "_MP_". */
+	uint32_t physaddr;              /* Address of the MP config table. */
+	uint8_t length;                 /* In 16-byte units, always 1. */
+	uint8_t specrev;                /* [MP] version. */
+	uint8_t checksum;               /* All bytes add up to 0. */
+	uint8_t type;                   /* Default config type, or 0. */
+	uint8_t imcrp;
+	uint8_t reserved[3];
+} __attribute__ ((packed));
+
+/* MP configuration table header, followed by ENTRY entries. */
+struct mpconf {
+	uint8_t signature[4];           /* "PCMP". */
+	uint16_t length;                /* Header and entries, in bytes. */
+	uint8_t version;                /* [MP] version. */
+	uint8_t checksum;               /* All bytes add up to 0. */
+	uint8_t product[20];
+	uint32_t oemtable;
+	uint16_t oemlength;
+	uint16_t entry;                 /* Number of entries. */
+	uint32_t lapicaddr;             /* Address of the local APICs. */
+	uint16_t xlength;
+	uint8_t xchecksum;
+	uint8_t reserved;
+} __attribute__ ((packed));
+
+/* Processor entry in the MP configuration table.  All other
+   entry types are 8 bytes long. */
+struct mpproc {
+	uint8_t type;                   /* MPPROC. */
+	uint8_t apicid;                 /* Local APIC ID. */
+	uint8_t version;
+	uint8_t flags;                  /* MPPROC_* below. */
+	uint8_t signature[4];
+	uint32_t feature;
+	uint8_t reserved[8];
+} __attribute__ ((packed));
+
+#define MPPROC 0x00                     /* Processor entry type. */
+#define MPPROC_ENABLED 0x01             /* Usable. */
+#define MPPROC_BSP 0x02                 /* The boot processor. */
+
+/* Local APIC registers, as byte offsets. */
+#define LAPIC_ID 0x020                  /* ID. */
+#define LAPIC_TPR 0x080                 /* Task priority. */
+#define LAPIC_EOI 0x0b0                 /* End of interrupt. */
+#define LAPIC_SVR 0x0f0                 /* Spurious interrupt vector. */
+#define LAPIC_ESR 0x280                 /* Error status. */
+#define LAPIC_ICRLO 0x300               /* Interrupt command, low half. */
+#define LAPIC_ICRHI 0x310               /* Interrupt command, high half. */
+#define LAPIC_TIMER 0x320               /* Local vector table: timer. */
+#define LAPIC_LINT0 0x350               /* Local vector table: LINT0. */
+#define LAPIC_LINT1 0x360               /* Local vector table: LINT1. */
+#define LAPIC_TICR 0x380                /* Timer initial count. */
+#define LAPIC_TCCR 0x390                /* Timer current count. */
+#define LAPIC_TDCR 0x3e0                /* Timer divide configuration. */
+
+/* Register bits. */
+#define LAPIC_ENABLE 0x00000100         /* SVR: APIC enable. */
+#define LAPIC_INIT 0x00000500           /* ICR: INIT IPI. */
+#define LAPIC_STARTUP 0x00000600        /* ICR: STARTUP IPI. */
+#define LAPIC_DELIVS 0x00001000         /* ICR: delivery pending. */
+#define LAPIC_ASSERT 0x00004000         /* ICR: assert level. */
+#define LAPIC_LEVEL 0x00008000          /* ICR: level triggered. */
+#define LAPIC_NMI 0x00000400            /* LVT: NMI delivery. */
+#define LAPIC_EXTINT 0x00000700         /* LVT: delivery through the PIC. */
+#define LAPIC_MASKED 0x00010000         /* LVT: masked. */
+#define LAPIC_PERIODIC 0x00020000       /* LVT timer: periodic mode. */
+#define LAPIC_X16 0x00000003            /* TDCR: divide the bus clock by 16. */
+
+/* Ticks over which smp_init() measures the local APIC timer. */
+#define CALIBRATE_TICKS 5
+
+/* How long smp_init() waits for an AP to check in.  Generous,
+   because under an emulator the AP's virtual CPU may not be
+   scheduled on the host for a long while. */
+#define AP_TIMEOUT_MS 10000
+
+/* CPUs found in the MP table, the boot processor first. */
+struct cpu cpus[CPU_MAX];
+
+/* Number of CPUs up and running, counting the boot processor.
+   An AP counts itself once it can take interrupts. */
+int cpu_cnt = 1;
+
+/* Set by smp_init() before the first AP starts.  Until then
+   every thread runs on the boot processor, and cpu_id() need
+   not look. */
+static bool smp_active;
+
+/* Local APIC registers, mapped uncached, or null if smp_init()
+   did not start any APs. */
+static volatile uint32_t *lapic;
+
+/* Local APIC timer counts per timer tick. */
+static uint32_t lapic_timer_count;
+
+/* Stack and page table for the next AP, read by ap_entry in
+   ap-start.S. */
+uint64_t ap_stack;
+uint64_t ap_cr3;
+
+/* The kernel lock.  See the comment at the top of smp.h.  The
+   boot processor holds it from the start. */
+static struct {
+	int locked;                     /* Held? */
+	int owner;                      /* Holding CPU, or -1. */
+} kernel_lock = { 1, 0 };
+
+void ap_main (void) NO_RETURN;
+static int mp_init (void);
+static void lapic_map (uint64_t pa);
+static void lapic_init (bool bsp);
+static void lapic_calibrate (void);
+static void lapic_start_ap (uint8_t apic_id);
+static intr_handler_func lapic_timer_interrupt;
+
+/* Starts every AP listed in the MP configuration table, or does
+   nothing on a uniprocessor.  Interrupts must be on, and the
+   timer calibrated. */
+void
+smp_init (void) {
+	extern char ap_start[], ap_start_end[];
+	int ncpu, i;
+
+	ASSERT (intr_get_level () == INTR_ON);
+
+	ncpu = mp_init ();
+	if (ncpu <= 1)
+		return;
+
+	lapic_calibrate ();
+	lapic_init (true);
+	intr_register_ext (LAPIC_TIMER_VEC, lapic_timer_interrupt,
+			"Local APIC Timer");
+
+	memcpy (ptov (AP_START), ap_start, ap_start_end - ap_start);
+	smp_active = true;
+	for (i = 1; i < ncpu; i++) {
+		struct thread *idle = thread_create_idle (i);
+		int ms;
+
+		if (idle == NULL)
+			PANIC ("out of memory starting CPU %d", i);
+		ap_stack = (uint64_t) idle + PGSIZE;
+		ap_cr3 = vtop (base_pml4);
+		lapic_start_ap (cpus[i].apic_id);
+
+		/* Sleeping gives up the kernel lock, which the AP needs. */
+		for (ms = 0; !cpus[i].started; ms++) {
+			if (ms >= AP_TIMEOUT_MS)
+				PANIC ("CPU %d (APIC %d) did not start", i, cpus[i].apic_id);
+			timer_msleep (1);
+		}
+	}
+	printf ("SMP: %d CPUs online.\n", cpu_cnt);
+}
+
+/* C entry point of an AP, called by ap_entry in ap-start.S on the
+   stack of the CPU's idle thread, with interrupts off.  Sets up
+   the CPU's own descriptor tables and local APIC, then becomes
+   its idle loop. */
+void
+ap_main (void) {
+	struct cpu *c;
+
+	kernel_lock_acquire ();
+	c = cpu_current ();
+#ifdef USERPROG
+	tss_init ();
+	gdt_init ();
+#endif
+	intr_init_cpu ();
+#ifdef USERPROG
+	syscall_init_cpu ();
+#endif
+	lapic_init (false);
+	profile_init_cpu ();
+
+	cpu_cnt++;
+	c->started = true;
+	thread_start_cpu ();
+	NOT_REACHED ();
+}
+
+/* Returns the index of the running CPU in cpus[]. */
+int
+cpu_id (void) {
+	struct thread *t;
+
+	if (!smp_active)
+		return 0;
+	/* Not thread_current(), which insists the thread be running:
+	   schedule() asks while it is switching. */
+	t = pg_round_down ((void *) rrsp ());
+	return t->cpu;
+}
+
+/* Returns the running CPU. */
+struct cpu *
+cpu_current (void) {
+	return &cpus[cpu_id ()];
+}
+
+/* Takes the kernel lock for the running CPU, spinning until no
+   other CPU holds it.  Interrupts must be off. */
+void
+kernel_lock_acquire (void) {
+	ASSERT (intr_get_level () == INTR_OFF);
+	ASSERT (!kernel_lock_held ());
+
+	while (__atomic_exchange_n (&kernel_lock.locked, 1, __ATOMIC_ACQUIRE))
+		asm volatile ("pause");
+	kernel_lock.owner = cpu_id ();
+}
+
+/* Releases the kernel lock, which the running CPU must hold.
+   Interrupts must be off, and stay off until the CPU leaves the
+   kernel. */
+void
+kernel_lock_release (void) {
+	ASSERT (intr_get_level () == INTR_OFF);
+	ASSERT (kernel_lock_held ());
+
+	kernel_lock.owner = -1;
+	__atomic_store_n (&kernel_lock.locked, 0, __ATOMIC_RELEASE);
+}
+
+/* Returns true if the running CPU holds the kernel lock. */
+bool
+kernel_lock_held (void) {
+	return __atomic_load_n (&kernel_lock.locked, __ATOMIC_ACQUIRE)
+		&& kernel_lock.owner == cpu_id ();
+}
+
+/* Returns the sum of the LEN bytes at ADDR, modulo 256. */
+static uint8_t
+sum (const void *addr, size_t len) {
+	const uint8_t *p = addr;
+	uint8_t s = 0;
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		s += p[i];
+	return s;
+}
+
+/* Looks for an MP floating pointer structure in the LEN bytes of
+   physical memory at PA. */
+static struct mp *
+mp_search_range (uint64_t pa, size_t len) {
+	uint8_t *p = ptov (pa);
+	uint8_t *end = p + len;
+
+	for (; p + sizeof (struct mp) <= end; p += sizeof (struct mp))
+		if (!memcmp (p, "_MP_", 4) && sum (p, sizeof (struct mp)) == 0)
+			return (struct mp *) p;
+	return NULL;
+}
+
+/* Looks for the MP floating pointer structure in the three places
+   [MP] 4 allows: the first KB of the EBDA, the last KB of base
+   memory, and the BIOS ROM between 0xf0000 and 0xfffff.  The
+   first two are found through the BIOS data area, which shares
+   physical page 0 with the initial thread's stack, so their
+   addresses are checked before use. */
+static struct mp *
+mp_search (void) {
+	uint8_t *bda = ptov (0x400);
+	uint64_t pa;
+	struct mp *mp;
+
+	pa = (uint64_t) *(uint16_t *) (bda + 0x0e) << 4;
+	if (pa >= 0x80000 && pa < 0xa0000
+			&& (mp = mp_search_range (pa, 1024)) != NULL)
+		return mp;
+	pa = (uint64_t) *(uint16_t *) (bda + 0x13) * 1024;
+	if (pa >= 0x80000 && pa <= 0xa0000
+			&& (mp = mp_search_range (pa - 1024, 1024)) != NULL)
+		return mp;
+	return mp_search_range (0xf0000, 0x10000);
+}
+
+/* Reads the MP configuration table into cpus[], maps the local
+   APIC, and returns the number of usable CPUs, the boot processor
+   being cpus[0].  Returns 1 if there is no table, in which case
+   only the boot processor runs. */
+static int
+mp_init (void) {
+	struct mp *mp;
+	struct mpconf *conf;
+	uint8_t *p, *end;
+	int ncpu = 1;
+
+	mp = mp_search ();
+	if (mp == NULL || mp->physaddr == 0)
+		return 1;
+	conf = ptov (mp->physaddr);
+	if (memcmp (conf, "PCMP", 4) || (conf->version != 1 && conf->version != 4)
+			|| sum (conf, conf->length) != 0)
+		return 1;
+
+	p = (uint8_t *) (conf + 1);
+	end = (uint8_t *) conf + conf->length;
+	while (p < end) {
+		struct mpproc *proc = (struct mpproc *) p;
+
+		if (*p != MPPROC) {
+			p += 8;
+			continue;
+		}
+		p += sizeof *proc;
+		if (!(proc->flags & MPPROC_ENABLED))
+			continue;
+		if (proc->flags & MPPROC_BSP)
+			cpus[0].apic_id = proc->apicid;
+		else if (ncpu < CPU_MAX) {
+			cpus[ncpu].id = ncpu;
+			cpus[ncpu].apic_id = proc->apicid;
+			ncpu++;
+		} else
+			printf ("SMP: ignoring CPU with APIC %d, too many CPUs.\n",
+					proc->apicid);
+	}
+	if (ncpu > 1)
+		lapic_map (conf->lapicaddr);
+	return ncpu;
+}
+
+/* Maps the local APIC registers at physical address PA into the
+   kernel's address space, uncached.  Every page table shares the
+   kernel's, so the mapping shows up in all of them. */
+static void
+lapic_map (uint64_t pa) {
+	uint64_t *pte = pml4e_walk (base_pml4, (uint64_t) ptov (pa), 1);
+
+	if (pte == NULL)
+		PANIC ("cannot map the local APIC");
+	*pte = pa | PTE_P | PTE_W | PTE_PWT | PTE_PCD;
+	lapic = ptov (pa);
+}
+
+/* Reads local APIC register REG. */
+static uint32_t
+lapic_read (int reg) {
+	return lapic[reg / 4];
+}
+
+/* Writes VALUE to local APIC register REG and waits for the
+   write to finish by reading back the ID. */
+static void
+lapic_write (int reg, uint32_t value) {
+	lapic[reg / 4] = value;
+	(void) lapic[LAPIC_ID / 4];
+}
+
+/* Sets up the running CPU's local APIC.  The boot processor
+   keeps taking PIC interrupts through LINT0 and its timer off,
+   since the PIT drives its ticks; an AP gets a periodic timer
+   instead. */
+static void
+lapic_init (bool bsp) {
+	lapic_write (LAPIC_SVR, LAPIC_ENABLE | LAPIC_SPURIOUS_VEC);
+	if (bsp) {
+		lapic_write (LAPIC_LINT0, LAPIC_EXTINT);
+		lapic_write (LAPIC_LINT1, LAPIC_NMI);
+		lapic_write (LAPIC_TIMER, LAPIC_MASKED);
+	} else {
+		lapic_write (LAPIC_LINT0, LAPIC_MASKED);
+		lapic_write (LAPIC_LINT1, LAPIC_MASKED);
+		lapic_write (LAPIC_TDCR, LAPIC_X16);
+		lapic_write (LAPIC_TIMER, LAPIC_PERIODIC | LAPIC_TIMER_VEC);
+		lapic_write (LAPIC_TICR, lapic_timer_count);
+	}
+
+	/* Clear errors, which takes two writes, and any interrupt
+	   left in service. */
+	lapic_write (LAPIC_ESR, 0);
+	lapic_write (LAPIC_ESR, 0);
+	lapic_write (LAPIC_EOI, 0);
+
+	/* Accept every interrupt. */
+	lapic_write (LAPIC_TPR, 0);
+}
+
+/* Measures the local APIC timer against the timer interrupt.
+   Every local APIC in the system runs off the same bus clock,
+   so the boot processor's serves for all. */
+static void
+lapic_calibrate (void) {
+	int64_t start;
+
+	lapic_write (LAPIC_TDCR, LAPIC_X16);
+	lapic_write (LAPIC_TIMER, LAPIC_MASKED);
+
+	/* Start on a tick boundary, then count down across
+	   CALIBRATE_TICKS whole ticks. */
+	start = timer_ticks ();
+	while (timer_ticks () == start)
+		barrier ();
+	start = timer_ticks ();
+	lapic_write (LAPIC_TICR, UINT32_MAX);
+	while (timer_ticks () - start < CALIBRATE_TICKS)
+		barrier ();
+	lapic_timer_count = (UINT32_MAX - lapic_read (LAPIC_TCCR))
+		/ CALIBRATE_TICKS;
+	lapic_write (LAPIC_TICR, 0);
+}
+
+/* Starts the AP with local APIC ID APIC_ID at AP_START, with the
+   INIT, STARTUP, STARTUP sequence of [MP] B.4.  The warm reset
+   vector that [MP] also asks for is only needed by external
+   APICs, and lives in the BIOS data area, which the initial
+   thread's stack overlays, so it is left alone. */
+static void
+lapic_start_ap (uint8_t apic_id) {
+	int i;
+
+	lapic_write (LAPIC_ICRHI, apic_id << 24);
+	lapic_write (LAPIC_ICRLO, LAPIC_INIT | LAPIC_LEVEL | LAPIC_ASSERT);
+	timer_usleep (200);
+	lapic_write (LAPIC_ICRLO, LAPIC_INIT | LAPIC_LEVEL);
+	timer_usleep (100);
+
+	for (i = 0; i < 2; i++) {
+		lapic_write (LAPIC_ICRHI, apic_id << 24);
+		lapic_write (LAPIC_ICRLO, LAPIC_STARTUP | (AP_START >> 12));
+		timer_usleep (200);
+	}
+}
+
+/* Sends CPU a reschedule IPI.  Interrupts must be off. */
+void
+smp_send_resched (int cpu) {
+	ASSERT (intr_get_level () == INTR_OFF);
+	ASSERT (cpu >= 0 && cpu < cpu_cnt);
+
+	while (lapic_read (LAPIC_ICRLO) & LAPIC_DELIVS)
+		asm volatile ("pause");
+	lapic_write (LAPIC_ICRHI, cpus[cpu].apic_id << 24);
+	lapic_write (LAPIC_ICRLO, LAPIC_RESCHED_VEC);
+}
+
+/* Acknowledges the local APIC interrupt in service. */
+void
+lapic_eoi (void) {
+	if (lapic != NULL)
+		lapic_write (LAPIC_EOI, 0);
+}
+
+/* Local APIC timer interrupt, the tick of an AP. */
+static void
+lapic_timer_interrupt (struct intr_frame *args) {
+	thread_tick ();
+	if (profile_enabled)
+		profile_sample (args);
+}
@@ -29,8 +29,42 @@
 #include "threads/synch.h"
 #include <stdio.h>
 #include <string.h>
+#include "devices/timer.h"
 #include "threads/interrupt.h"
 #include "threads/thread.h"
+#include "threads/trace.h"
+#include "threads/vaddr.h"
+#include "intrinsic.h"
+
+static heap_less_func sema_waiter_less;
+static heap_less_func cond_waiter_less;
+static void lock_acquire_at (struct lock *, void *site);
+
+#ifdef LOCKSTAT
+/* Contention statistics for the locks initialized at INIT_SITE
+   and acquired at ACQUIRE_SITE.  Times are in nanoseconds. */
+struct lockstat {
+	void *init_site;            /* Caller of lock_init(). */
+	void *acquire_site;         /* Caller of lock_acquire(). */
+	uint64_t acquisitions;      /* Times acquired. */
+	uint64_t contended;         /* Times a waiter had to sleep. */
+	int64_t wait_total;         /* Time spent sleeping for it. */
+	int64_t wait_max;           /* Longest single sleep. */
+	int64_t hold_total;         /* Time spent holding it. */
+	int64_t hold_max;           /* Longest single hold. */
+};
+
+/* Open-addressed table of call-site pairs.  It is static because
+   locks are taken before malloc() works; pairs that do not fit
+   are only counted. */
+#define LOCKSTAT_CNT 512
+#define LOCKSTAT_TOP 10
+static struct lockstat lockstats[LOCKSTAT_CNT];
+static uint64_t lockstat_overflow;
+
+static struct lockstat *lockstat_lookup (const struct lock *, void *site);
+static void lockstat_acquired (struct lock *, void *site, int64_t start);
+#endif
 
 /* Initializes semaphore SEMA to VALUE.  A semaphore is a
    nonnegative integer along with two atomic operators for
@@ -47,14 +81,14 @@ sema_init (struct semaphore *sema, unsigned value) {
 	ASSERT (sema != NULL);
 
 	sema->value = value;
-	list_init (&sema->waiters);
+	heap_init (&sema->waiters, sema_waiter_less, NULL);
 }
 
-/* One semaphore in a list. */
+/* One semaphore in a condition's wait queue. */
 struct semaphore_elem {
-	struct list_elem elem;              /* List element. */
+	struct heap_elem elem;              /* Heap element. */
 	struct semaphore semaphore;         /* This semaphore. */
-	int sema_priority;
+	struct thread *thread;              /* The thread waiting on it. */
 };
 
 /* Down or "P" operation on a semaphore.  Waits for SEMA's value
@@ -76,27 +110,65 @@ sema_down (struct semaphore *sema) {
 	old_level = intr_disable ();
 
 	while (sema->value == 0) {
-		list_insert_ordered (&sema->waiters, &thread_current()->elem,
-		cmp_priority, NULL);
+		struct thread *cur = thread_current ();
+
+		TRACE (TRACE_SEMA_BLOCK, cur->tid, (int) (uintptr_t) sema, 0);
+		cur->waiting_on = sema;
+		heap_insert (&sema->waiters, &cur->wait_elem);
 		thread_block ();	// context switching
 	}
 	sema->value--;
 	intr_set_level (old_level);
 }
 
-/* 첫 번째 인자의 우선순위가 두 번째 인자의 우선순위보다 높으면 1을 반환 낮으면 0을 반환 */
-bool cmp_sem_priority (const struct list_elem *a, const struct list_elem *b,
-void *aux UNUSED){
-	struct semaphore_elem *sa = list_entry(a, struct semaphore_elem, elem);
-	struct semaphore_elem *sb = list_entry(b, struct semaphore_elem, elem);
+/* Like sema_down(), but gives up once TICKS timer ticks have
+   passed without SEMA becoming positive.  Returns true if SEMA
+   was decremented, false on timeout.
 
-	/* 해당 condition variable 을 기다리는 세마포어 리스트를
-	가장 높은 우선순위를 가지는 스레드의 우선순위 순으로 정렬하도록 구현 */
-	if (sa->sema_priority > sb->sema_priority){
-		return true;
-	}else{
-		return false;
+   The waiting thread sits both in SEMA's waiters and in the
+   sleep queue.  Whichever of sema_up() and the timer gets to it
+   first takes it out of the other's queue, with interrupts off,
+   so it is woken exactly once.  An up that races with the
+   timeout is not lost: it stays in SEMA's value, which is
+   checked again before giving up. */
+bool
+sema_down_timeout (struct semaphore *sema, int64_t ticks) {
+	enum intr_level old_level;
+	int64_t deadline;
+	bool success = true;
+
+	ASSERT (sema != NULL);
+	ASSERT (!intr_context ());
+
+	old_level = intr_disable ();
+	deadline = timer_ticks ();
+	deadline = ticks > INT64_MAX - deadline ? INT64_MAX : deadline + ticks;
+
+	while (sema->value == 0) {
+		struct thread *cur = thread_current ();
+
+		if (timer_ticks () >= deadline) {
+			success = false;
+			break;
+		}
+		TRACE (TRACE_SEMA_BLOCK, cur->tid, (int) (uintptr_t) sema, 0);
+		cur->waiting_on = sema;
+		heap_insert (&sema->waiters, &cur->wait_elem);
+		thread_sleep (deadline);
 	}
+	if (success)
+		sema->value--;
+	intr_set_level (old_level);
+	return success;
+}
+
+/* Orders a semaphore's waiters by priority, highest first.
+   Equal priorities wake in arrival order. */
+static bool
+sema_waiter_less (const struct heap_elem *a, const struct heap_elem *b,
+		void *aux UNUSED) {
+	return heap_entry (a, struct thread, wait_elem)->priority
+		> heap_entry (b, struct thread, wait_elem)->priority;
 }
 
 
@@ -137,11 +209,14 @@ sema_up (struct semaphore *sema) {
 	ASSERT (sema != NULL);
 
 	old_level = intr_disable ();
-	if (!list_empty (&sema->waiters)){
-		/* 스레드가 waiters list에 있는 동안 우선순위가 변경 되었을 경우를 
-		고려 하여 waiters list 를 우선순위로 정렬 */
-		list_sort(&sema->waiters, cmp_priority, NULL);
-		thread_unblock (list_entry (list_pop_front (&sema->waiters), struct thread, elem));
+	if (!heap_empty (&sema->waiters)){
+		/* 대기 중 우선순위가 바뀌면 synch_requeue() 가 heap 을 갱신하므로
+		   top 이 항상 가장 높은 우선순위의 스레드 */
+		struct thread *t = heap_entry (heap_pop (&sema->waiters),
+				struct thread, wait_elem);
+		t->waiting_on = NULL;
+		thread_sleep_cancel (t);
+		thread_unblock (t);
 	}
 	sema->value++;
 	/* 우선순위에 따라 선점이 발생하도록 */
@@ -205,6 +280,10 @@ lock_init (struct lock *lock) {
 
 	lock->holder = NULL;
 	sema_init (&lock->semaphore, 1);
+#ifdef LOCKSTAT
+	lock->init_site = __builtin_return_address (0);
+	lock->stat = NULL;
+#endif
 }
 
 /* Acquires LOCK, sleeping until it becomes available if
@@ -218,23 +297,97 @@ lock_init (struct lock *lock) {
 /* lock을 요청 */
 void
 lock_acquire (struct lock *lock) {
+	lock_acquire_at (lock, __builtin_return_address (0));
+}
+
+/* Does the work of lock_acquire().  SITE is the caller charged
+   for any wait under LOCKSTAT, so that wrappers such as the
+   rwlock functions can pass on their own caller. */
+static void
+lock_acquire_at (struct lock *lock, void *site UNUSED) {
 	ASSERT (lock != NULL);
 	ASSERT (!intr_context ());
 	ASSERT (!lock_held_by_current_thread (lock));
 	struct thread *cur = thread_current();
+	int64_t start = lock->holder != NULL ? timer_ticks () : -1;
 	/* 해당 lock 의 holder가 존재 한다면 아래 작업을 수행 */
 	/* 현재 스레드의 wait_on_lock 변수에 획득 하기를 기다리는 lock의 주소를 저장 */ 
-	if(lock->holder != NULL){
+	if(lock->holder != NULL && !thread_mlfqs){	/* 4.4BSD scheduler 에서는 donation 하지 않음 */
 		cur->wait_on_lock = lock;
 		/* donation 을 받은 스레드의 thread 구조체를 list로 관리 */
 		list_insert_ordered(&lock->holder->donations, &cur->donation_elem, cmp_don_priority ,NULL);
 		/* priority donation 수행하기 위해 donate_priority() 함수 호출 */
 		donate_priority();
 	}
+#ifdef LOCKSTAT
+	int64_t wait_start = start >= 0 ? timer_clock_ns () : -1;
+#endif
 	sema_down (&lock->semaphore);
+	if (start >= 0)
+		cur->lock_ticks += timer_ticks () - start;
 	cur->wait_on_lock = NULL;
 	/* lock을 획득 한 후 lock holder 를 갱신한다. */
 	lock->holder = thread_current();
+#ifdef LOCKSTAT
+	lockstat_acquired (lock, site, wait_start);
+#endif
+}
+
+/* Like lock_acquire(), but gives up once TICKS timer ticks have
+   passed without acquiring LOCK.  Returns true if LOCK was
+   acquired, false on timeout.  On timeout, the priority this
+   thread donated to the holder is taken back, from the holder
+   and from any thread the holder passed it on to. */
+bool
+lock_acquire_timeout (struct lock *lock, int64_t ticks) {
+	struct thread *cur = thread_current ();
+	enum intr_level old_level;
+	bool donated = false;
+	int64_t start;
+	bool success;
+
+	ASSERT (lock != NULL);
+	ASSERT (!intr_context ());
+	ASSERT (!lock_held_by_current_thread (lock));
+
+	old_level = intr_disable ();
+	start = lock->holder != NULL ? timer_ticks () : -1;
+#ifdef LOCKSTAT
+	int64_t wait_start = start >= 0 ? timer_clock_ns () : -1;
+#endif
+	if (lock->holder != NULL && !thread_mlfqs) {
+		cur->wait_on_lock = lock;
+		list_insert_ordered (&lock->holder->donations, &cur->donation_elem,
+				cmp_don_priority, NULL);
+		donate_priority ();
+		donated = true;
+	}
+	success = sema_down_timeout (&lock->semaphore, ticks);
+	if (start >= 0)
+		cur->lock_ticks += timer_ticks () - start;
+	cur->wait_on_lock = NULL;
+
+	if (success) {
+		lock->holder = cur;
+#ifdef LOCKSTAT
+		lockstat_acquired (lock, __builtin_return_address (0), wait_start);
+#endif
+	} else if (donated && lock->holder != NULL) {
+		/* If the holder released the lock meanwhile, lock_release()
+		   already dropped our donation.  Otherwise it is still on
+		   the holder's list. */
+		struct list_elem *e;
+
+		for (e = list_begin (&lock->holder->donations);
+				e != list_end (&lock->holder->donations); e = list_next (e))
+			if (e == &cur->donation_elem) {
+				list_remove (e);
+				refresh_priority_chain (lock->holder);
+				break;
+			}
+	}
+	intr_set_level (old_level);
+	return success;
 }
 
 /* Tries to acquires LOCK and returns true if successful or false
@@ -251,8 +404,12 @@ lock_try_acquire (struct lock *lock) {
 	ASSERT (!lock_held_by_current_thread (lock));
 
 	success = sema_try_down (&lock->semaphore);
-	if (success)
+	if (success) {
 		lock->holder = thread_current ();
+#ifdef LOCKSTAT
+		lockstat_acquired (lock, __builtin_return_address (0), -1);
+#endif
+	}
 	return success;
 }
 
@@ -268,10 +425,24 @@ lock_release (struct lock *lock) {
 	ASSERT (lock != NULL);
 	ASSERT (lock_held_by_current_thread (lock));
 
-	/* lock 을 해지 했을때 donations 리스트에서 해당 엔트리를 삭제 하기 위한 함수 */
-	remove_with_lock(lock);
-	/* 스레드의 우선순위가 변경 되었을때 donation 을 고려하여 우선순위를 다시 결정 하는 함수 */
-	refresh_priority();
+	if (!thread_mlfqs) {
+		/* lock 을 해지 했을때 donations 리스트에서 해당 엔트리를 삭제 하기 위한 함수 */
+		remove_with_lock(lock);
+		/* 스레드의 우선순위가 변경 되었을때 donation 을 고려하여 우선순위를 다시 결정 하는 함수 */
+		refresh_priority();
+	}
+#ifdef LOCKSTAT
+	if (lock->stat != NULL) {
+		int64_t held = timer_clock_ns () - lock->acquired_at;
+		enum intr_level old_level = intr_disable ();
+
+		lock->stat->hold_total += held;
+		if (held > lock->stat->hold_max)
+			lock->stat->hold_max = held;
+		lock->stat = NULL;
+		intr_set_level (old_level);
+	}
+#endif
 	lock->holder = NULL;
 	sema_up (&lock->semaphore);
 }
@@ -285,7 +456,258 @@ lock_held_by_current_thread (const struct lock *lock) {
 
 	return lock->holder == thread_current ();
 }
+
+#ifdef LOCKSTAT
+/* Returns the statistics entry for LOCK acquired at SITE,
+   creating it if necessary, or a null pointer if the table is
+   full.  Interrupts must be off. */
+static struct lockstat *
+lockstat_lookup (const struct lock *lock, void *site) {
+	uintptr_t hash = ((uintptr_t) lock->init_site * 31 + (uintptr_t) site)
+		* 0x9e3779b97f4a7c15ULL;
+	size_t i, slot;
+
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	slot = (hash >> 32) % LOCKSTAT_CNT;
+	for (i = 0; i < LOCKSTAT_CNT; i++, slot = (slot + 1) % LOCKSTAT_CNT) {
+		struct lockstat *ls = &lockstats[slot];
+
+		if (ls->acquire_site == NULL) {
+			ls->init_site = lock->init_site;
+			ls->acquire_site = site;
+			return ls;
+		}
+		if (ls->init_site == lock->init_site && ls->acquire_site == site)
+			return ls;
+	}
+	return NULL;
+}
+
+/* Records that the current thread just acquired LOCK at SITE.
+   If it had to wait, START is when it started waiting, otherwise
+   -1. */
+static void
+lockstat_acquired (struct lock *lock, void *site, int64_t start) {
+	int64_t now = timer_clock_ns ();
+	enum intr_level old_level = intr_disable ();
+	struct lockstat *ls = lockstat_lookup (lock, site);
+
+	if (ls != NULL) {
+		ls->acquisitions++;
+		if (start >= 0) {
+			int64_t waited = now - start;
+
+			ls->contended++;
+			ls->wait_total += waited;
+			if (waited > ls->wait_max)
+				ls->wait_max = waited;
+		}
+	} else
+		lockstat_overflow++;
+	lock->stat = ls;
+	lock->acquired_at = now;
+	intr_set_level (old_level);
+}
+
+/* Prints the LOCKSTAT_TOP lock call sites with the most time
+   spent waiting.  Feed the addresses to utils/backtrace to see
+   where they are. */
+void
+lockstat_print (void) {
+	uint16_t order[LOCKSTAT_CNT];
+	size_t cnt = 0, i, j;
+
+	for (i = 0; i < LOCKSTAT_CNT; i++)
+		if (lockstats[i].contended > 0)
+			order[cnt++] = i;
+
+	/* Selection sort, just far enough for the top entries. */
+	for (i = 0; i < cnt && i < LOCKSTAT_TOP; i++)
+		for (j = i + 1; j < cnt; j++) {
+			const struct lockstat *a = &lockstats[order[i]];
+			const struct lockstat *b = &lockstats[order[j]];
+
+			if (b->wait_total > a->wait_total
+					|| (b->wait_total == a->wait_total
+						&& b->contended > a->contended)) {
+				uint16_t t = order[i];
+				order[i] = order[j];
+				order[j] = t;
+			}
+		}
+
+	printf ("Lock stats: %zu contended call sites", cnt);
+	if (lockstat_overflow > 0)
+		printf (", %llu acquisitions not recorded", lockstat_overflow);
+	printf ("\n");
+	if (cnt == 0)
+		return;
+	printf ("%18s %18s %9s %9s %10s %9s %10s %9s\n",
+			"init", "acquire", "acquired", "contended",
+			"wait(us)", "max(us)", "hold(us)", "max(us)");
+	for (i = 0; i < cnt && i < LOCKSTAT_TOP; i++) {
+		const struct lockstat *ls = &lockstats[order[i]];
+
+		printf ("%18p %18p %9llu %9llu %10lld %9lld %10lld %9lld\n",
+				ls->init_site, ls->acquire_site,
+				ls->acquisitions, ls->contended,
+				ls->wait_total / 1000, ls->wait_max / 1000,
+				ls->hold_total / 1000, ls->hold_max / 1000);
+	}
+}
+#endif
+
+/* Initializes RW, which is not held by anyone. */
+void
+rwlock_init (struct rwlock *rw) {
+	ASSERT (rw != NULL);
+
+	lock_init (&rw->lock);
+#ifdef LOCKSTAT
+	/* Attribute the lock to whoever owns the rwlock. */
+	rw->lock.init_site = __builtin_return_address (0);
+#endif
+	rw->readers = 0;
+	rw->writer_waiting = false;
+	sema_init (&rw->drained, 0);
+}
+
+/* Acquires RW for reading, sleeping while a writer holds it or
+   waits for it.  A reader blocked here donates its priority to
+   the writer.  The reader itself holds no lock afterward, so a
+   writer that later waits for readers to leave cannot donate to
+   them; reader critical sections must therefore stay short and
+   must not wait on RW again.
+
+   This function may sleep, so it must not be called within an
+   interrupt handler. */
+void
+rwlock_acquire_read (struct rwlock *rw) {
+	enum intr_level old_level;
+
+	ASSERT (rw != NULL);
+	ASSERT (!intr_context ());
+
+	lock_acquire_at (&rw->lock, __builtin_return_address (0));
+	old_level = intr_disable ();
+	rw->readers++;
+	intr_set_level (old_level);
+	lock_release (&rw->lock);
+}
+
+/* Releases RW, which the current thread holds for reading, and
+   wakes a waiting writer if this was the last reader. */
+void
+rwlock_release_read (struct rwlock *rw) {
+	enum intr_level old_level;
+
+	ASSERT (rw != NULL);
+
+	old_level = intr_disable ();
+	ASSERT (rw->readers > 0);
+	if (--rw->readers == 0 && rw->writer_waiting)
+		sema_up (&rw->drained);
+	intr_set_level (old_level);
+}
+
+/* Acquires RW for writing, sleeping until no other writer holds
+   it and every reader has released it.
+
+   This function may sleep, so it must not be called within an
+   interrupt handler. */
+void
+rwlock_acquire_write (struct rwlock *rw) {
+	enum intr_level old_level;
+
+	ASSERT (rw != NULL);
+	ASSERT (!intr_context ());
+
+	lock_acquire_at (&rw->lock, __builtin_return_address (0));
+	old_level = intr_disable ();
+	while (rw->readers > 0) {
+		rw->writer_waiting = true;
+		sema_down (&rw->drained);
+	}
+	rw->writer_waiting = false;
+	intr_set_level (old_level);
+}
+
+/* Releases RW, which the current thread holds for writing. */
+void
+rwlock_release_write (struct rwlock *rw) {
+	ASSERT (rw != NULL);
+	ASSERT (rwlock_held_for_write (rw));
+
+	lock_release (&rw->lock);
+}
+
+/* Returns true if the current thread holds RW for writing. */
+bool
+rwlock_held_for_write (const struct rwlock *rw) {
+	ASSERT (rw != NULL);
+
+	return lock_held_by_current_thread (&rw->lock) && rw->readers == 0;
+}
 
+/* Initializes LOCK.  A spinlock protects data shared with
+   interrupt handlers, replacing a bare intr_disable() around
+   it.  Unlike a lock, it may be acquired in an interrupt
+   handler, but waiting for it burns CPU rather than sleeping,
+   so it should only be held for short stretches. */
+void
+spinlock_init (struct spinlock *lock) {
+	ASSERT (lock != NULL);
+
+	lock->locked = 0;
+	lock->holder = NULL;
+	lock->old_level = INTR_OFF;
+}
+
+/* Disables interrupts and acquires LOCK, spinning until it is
+   available.  Interrupts stay off until the matching
+   spinlock_release().
+
+   This function may be called in an interrupt handler and
+   before the thread system is initialized. */
+void
+spinlock_acquire (struct spinlock *lock) {
+	enum intr_level old_level;
+
+	ASSERT (lock != NULL);
+
+	old_level = intr_disable ();
+	ASSERT (!spinlock_held_by_current_thread (lock));
+	while (__atomic_exchange_n (&lock->locked, 1, __ATOMIC_ACQUIRE))
+		asm volatile ("pause");
+	lock->holder = pg_round_down ((void *) rrsp ());
+	lock->old_level = old_level;
+}
+
+/* Releases LOCK, which must be held by the current thread, and
+   restores the interrupt level from before spinlock_acquire(). */
+void
+spinlock_release (struct spinlock *lock) {
+	enum intr_level old_level;
+
+	ASSERT (spinlock_held_by_current_thread (lock));
+
+	old_level = lock->old_level;
+	lock->holder = NULL;
+	__atomic_store_n (&lock->locked, 0, __ATOMIC_RELEASE);
+	intr_set_level (old_level);
+}
+
+/* Returns true if the current thread holds LOCK, false
+   otherwise.  Interrupt handlers count as the thread they
+   interrupted. */
+bool
+spinlock_held_by_current_thread (const struct spinlock *lock) {
+	ASSERT (lock != NULL);
+
+	return lock->locked && lock->holder == pg_round_down ((void *) rrsp ());
+}
+
 
 /* Initializes condition variable COND.  A condition variable
    allows one piece of code to signal a condition and cooperating
@@ -294,7 +716,7 @@ void
 cond_init (struct condition *cond) {
 	ASSERT (cond != NULL);
 
-	list_init (&cond->waiters);	
+	heap_init (&cond->waiters, cond_waiter_less, NULL);
 }
 
 /* Atomically releases LOCK and waits for COND to be signaled by
@@ -320,7 +742,9 @@ cond_init (struct condition *cond) {
 /* condition variable을 통해 signal이 오는지 기다림. 마치 sema_down */
 void
 cond_wait (struct condition *cond, struct lock *lock) {
+	struct thread *cur = thread_current ();
 	struct semaphore_elem waiter;
+	enum intr_level old_level;
 
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
@@ -328,14 +752,61 @@ cond_wait (struct condition *cond, struct lock *lock) {
 	ASSERT (lock_held_by_current_thread (lock));
 
 	sema_init (&waiter.semaphore, 0);
-	/* condition variable의 waiters list에 우선순위 순서로 삽입되도록 수정 */
-	waiter.sema_priority = thread_get_priority();
-	list_insert_ordered (&cond->waiters, &waiter.elem, cmp_sem_priority, NULL); 
+	waiter.thread = cur;
+	/* condition variable의 waiters heap에 우선순위 순서로 삽입.
+	   The timer interrupt may reorder it under -mlfqs. */
+	old_level = intr_disable ();
+	cur->wait_cond = cond;
+	cur->cond_elem = &waiter.elem;
+	heap_insert (&cond->waiters, &waiter.elem);
+	intr_set_level (old_level);
 	lock_release (lock);
 	sema_down (&waiter.semaphore);
 	lock_acquire (lock);
 }
 
+/* Like cond_wait(), but stops waiting once TICKS timer ticks
+   have passed without COND being signaled.  LOCK is reacquired
+   before returning either way, without a time limit.  Returns
+   true if COND was signaled, false on timeout. */
+bool
+cond_wait_timeout (struct condition *cond, struct lock *lock,
+		int64_t ticks) {
+	struct thread *cur = thread_current ();
+	struct semaphore_elem waiter;
+	enum intr_level old_level;
+	bool signaled;
+
+	ASSERT (cond != NULL);
+	ASSERT (lock != NULL);
+	ASSERT (!intr_context ());
+	ASSERT (lock_held_by_current_thread (lock));
+
+	sema_init (&waiter.semaphore, 0);
+	waiter.thread = cur;
+	old_level = intr_disable ();
+	cur->wait_cond = cond;
+	cur->cond_elem = &waiter.elem;
+	heap_insert (&cond->waiters, &waiter.elem);
+	intr_set_level (old_level);
+	lock_release (lock);
+	signaled = sema_down_timeout (&waiter.semaphore, ticks);
+
+	/* A signal may still arrive until we leave COND's queue. */
+	old_level = intr_disable ();
+	if (!signaled) {
+		if (cur->wait_cond != NULL) {
+			heap_remove (&cond->waiters, &waiter.elem);
+			cur->wait_cond = NULL;
+			cur->cond_elem = NULL;
+		} else
+			signaled = sema_try_down (&waiter.semaphore);
+	}
+	intr_set_level (old_level);
+	lock_acquire (lock);
+	return signaled;
+}
+
 /* If any threads are waiting on COND (protected by LOCK), then
    this function signals one of them to wake up from its wait.
    LOCK must be held before calling this function.
@@ -346,16 +817,23 @@ cond_wait (struct condition *cond, struct lock *lock) {
 /*  condition variable에서 기다리는 가장 높은 우선순위의 스레드에 signal을 보냄 */
 void
 cond_signal (struct condition *cond, struct lock *lock UNUSED) {
+	enum intr_level old_level;
+
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
 	ASSERT (!intr_context ());
 	ASSERT (lock_held_by_current_thread (lock));
 
-	if (!list_empty (&cond->waiters))
-		 /* condition variable의 waiters list를 우선순위로 재정렬 */
-		list_sort(&cond->waiters, cmp_sem_priority, NULL);
-		sema_up (&list_entry (list_pop_front (&cond->waiters),
-					struct semaphore_elem, elem)->semaphore);
+	old_level = intr_disable ();
+	if (!heap_empty (&cond->waiters)) {
+		struct semaphore_elem *waiter = heap_entry (
+				heap_pop (&cond->waiters), struct semaphore_elem, elem);
+
+		waiter->thread->wait_cond = NULL;
+		waiter->thread->cond_elem = NULL;
+		sema_up (&waiter->semaphore);
+	}
+	intr_set_level (old_level);
 }
 
 /* Wakes up all threads, if any, waiting on COND (protected by
@@ -370,6 +848,41 @@ cond_broadcast (struct condition *cond, struct lock *lock) {
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
 
-	while (!list_empty (&cond->waiters))
+	while (!heap_empty (&cond->waiters))
 		cond_signal (cond, lock);
 }
+
+/* Orders a condition's waiters by the priority of the waiting
+   thread, highest first. */
+static bool
+cond_waiter_less (const struct heap_elem *a, const struct heap_elem *b,
+		void *aux UNUSED) {
+	return heap_entry (a, struct semaphore_elem, elem)->thread->priority
+		> heap_entry (b, struct semaphore_elem, elem)->thread->priority;
+}
+
+/* Restores the order of the wait queues that T sits in after T's
+   priority changed, e.g. through donation, so that sema_up() and
+   cond_signal() keep waking the highest-priority waiter.  Costs
+   O(log n) per queue.  Must be called with interrupts off. */
+void
+synch_requeue (struct thread *t) {
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	if (t->waiting_on != NULL)
+		heap_update (&t->waiting_on->waiters, &t->wait_elem);
+	if (t->wait_cond != NULL)
+		heap_update (&t->wait_cond->waiters, t->cond_elem);
+}
+
+/* Takes T, whose timed wait on a semaphore has expired, out of
+   the semaphore's waiters.  Called by the timer interrupt, with
+   interrupts off, just before T is unblocked. */
+void
+synch_cancel_wait (struct thread *t) {
+	ASSERT (intr_get_level () == INTR_OFF);
+	ASSERT (t->waiting_on != NULL);
+
+	heap_remove (&t->waiting_on->waiters, &t->wait_elem);
+	t->waiting_on = NULL;
+}
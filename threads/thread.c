@@ -8,8 +8,13 @@
 #include "threads/interrupt.h"
 #include "threads/intr-stubs.h"
 #include "threads/palloc.h"
+#include "threads/smp.h"
+#include "threads/switch.h"
 #include "threads/synch.h"
+#include "threads/trace.h"
 #include "threads/vaddr.h"
+#include "devices/timer.h"
+#include "filesys/directory.h"
 #include "intrinsic.h"
 #ifdef USERPROG
 #include "userprog/process.h"
@@ -24,16 +29,88 @@
    Do not modify this value. */
 #define THREAD_BASIC 0xd42df210
 
-/* List of processes in THREAD_READY state, that is, processes
-   that are ready to run but not actually running. */
-static struct list ready_list;
-
-static struct list sleep_list;
+/* Run queue of processes in THREAD_READY state, that is,
+   processes that are ready to run but not actually running.
+   There is one FIFO list per priority level, and bit P of
+   ready_mask is set if and only if ready_queues[P] is non-empty,
+   so enqueue, dequeue and finding the highest ready priority all
+   take constant time regardless of how many threads are ready.
+
+   Every ready thread sits in the list for its current `priority'.
+   Code that changes the priority of a thread that may be ready
+   must go through thread_update_priority() to keep it that way.
+
+   Under -stride, the run queue is instead a heap ordered by
+   pass, and the priority queues stay empty.  A thread's pass
+   advances by its stride for every tick it runs, so over time
+   each thread runs in proportion to its tickets.  GLOBAL_PASS
+   is the pass of the last thread picked; a thread that was
+   blocked rejoins there, so sleeping earns no credit.
+
+   Each CPU has a run queue of its own, and a ready thread waits
+   in the one of the CPU it last ran on, its `cpu'.  Only user
+   processes move between CPUs: kernel threads stay on the boot
+   processor, which owns the devices, so they keep the ordering
+   they have always had.  A CPU with nothing to run steals a user
+   process from the busiest other queue.  All of the queues share
+   RUNQ_LOCK. */
+#if PRI_MAX >= 64
+#error ready_mask holds at most 64 priority levels
+#endif
+struct runq {
+	struct list ready_queues[PRI_MAX + 1];
+	uint64_t ready_mask;
+	int ready_cnt;			/* # of threads in the run queue. */
+	struct heap stride_queue;	/* Under -stride. */
+	struct heap edf_queue;		/* EDF class, see below. */
+};
+static struct runq runqs[CPU_MAX];
+static struct spinlock runq_lock;
+
+#define STRIDE1 (1 << 20)
+static uint64_t global_pass;
+
+/* Earliest-deadline-first class, above both of the above.  A
+   thread in the class with budget left in its period waits in
+   its run queue's EDF_QUEUE, ordered by absolute deadline, and
+   runs before any other thread.  Once its budget is spent it
+   falls back to its normal class until its next job is released,
+   either by thread_wait_period() or, for a job still unfinished
+   when its period ends, by the timer tick in
+   thread_edf_release().
+
+   Admission control keeps the sum of runtime / deadline over all
+   EDF threads, in millionths, at or below EDF_UTIL_MAX, which by
+   the density test guarantees every deadline.  The headroom left
+   covers tick-granular budget accounting and lets normal threads
+   run.  EDF_UTIL and EDF_LIST, which holds every thread in the
+   class whatever its state, are guarded by runq_lock. */
+#define EDF_UTIL_SCALE 1000000
+#define EDF_UTIL_MAX (EDF_UTIL_SCALE * 9 / 10)
+static int64_t edf_util;
+static struct list edf_list;
+
+/* List of all processes.  Processes are added to this list
+   when they are first scheduled and removed when they exit. */
+static struct list all_list;
+static struct spinlock all_lock;
+
+/* Sleeping threads, ordered by wakeup_tick so that the timer
+   interrupt only has to look at threads that are due. */
+static struct heap sleep_heap;
+static struct spinlock sleep_lock;
+
+/* The timer interrupt reaches all of the above, so each is
+   guarded by a spinlock rather than a lock.  When more than one
+   is needed, they nest in the order all_lock, sleep_lock,
+   runq_lock. */
 
 int64_t next_tick_to_awake = INT64_MAX;
 
-/* Idle thread. */
-static struct thread *idle_thread;
+/* Idle thread of each CPU, and the thread each CPU is running.
+   Guarded by runq_lock. */
+static struct thread *idle_threads[CPU_MAX];
+static struct thread *cpu_threads[CPU_MAX];
 
 /* Initial thread, the thread running init.c:main(). */
 static struct thread *initial_thread;
@@ -44,6 +121,25 @@ static struct lock tid_lock;
 /* Thread destruction requests */
 static struct list destruction_req;
 
+/* Free-thread cache.  Pages of dead threads, linked through
+   their elem, and fd tables of exited processes, waiting to be
+   reused by thread_create() without another palloc call and
+   without clearing them in full: init_thread() resets only the
+   struct thread at the bottom of a page, and process_exit()
+   hands back fd tables with every slot already closed.  Both
+   hold at most thread_cache_max entries.  Guarded by a spinlock,
+   because do_schedule() fills the page cache. */
+int thread_cache_max = THREAD_CACHE_DEFAULT;
+static struct spinlock cache_lock;
+static struct list page_cache;
+static int page_cache_cnt;
+static struct file **fdt_cache;     /* Linked through slot 0. */
+static int fdt_cache_cnt;
+
+/* Switch by whole interrupt frames instead of switch_threads()?
+   See thread_launch(). */
+bool thread_iret_switch;
+
 /* Statistics. */
 static long long idle_ticks;    /* # of timer ticks spent idle. */
 static long long kernel_ticks;  /* # of timer ticks in kernel threads. */
@@ -51,25 +147,75 @@ static long long user_ticks;    /* # of timer ticks in user programs. */
 
 /* Scheduling. */
 #define TIME_SLICE 4            /* 각 스레드를 제공하는 시간 눈금 */
-static unsigned thread_ticks;   /* # of timer ticks since last yield. */
+static unsigned thread_ticks[CPU_MAX]; /* # of timer ticks since last yield. */
 
 /* If false (default), use round-robin scheduler.
    If true, use multi-level feedback queue scheduler.
    Controlled by kernel command-line option "-o mlfqs". */
 bool thread_mlfqs;
 
+/* If true, use the stride scheduler.
+   Controlled by kernel command-line option "-stride". */
+bool thread_stride;
+
+/* 4.4BSD scheduler state.  The system load average, an
+   exponentially weighted moving average of the number of
+   threads ready to run over the past minute. */
+static fixed_t load_avg;
+
 static void kernel_thread (thread_func *, void *aux);
 
 static void idle (void *aux UNUSED);
 static struct thread *next_thread_to_run (void);
 static void init_thread (struct thread *, const char *name, int priority);
+static void runq_push (struct thread *);
+static void runq_remove (struct thread *);
+static struct thread *runq_pop (struct runq *);
+static struct thread *runq_steal (int cpu);
+static void runq_kick (struct thread *);
+static int runq_max_priority (const struct runq *);
+static void thread_update_priority (struct thread *, int priority);
+static void mlfqs_tick (struct thread *, int64_t now);
+static void mlfqs_update_priority (struct thread *);
+static heap_less_func wakeup_less;
+static heap_less_func pass_less;
+static heap_less_func deadline_less;
+static intr_handler_func resched_interrupt;
+static int64_t edf_density (const struct thread *);
+static void edf_tick (struct thread *);
 static void do_schedule(int status);
 static void schedule (void);
 static tid_t allocate_tid (void);
+static struct thread *thread_page_alloc (void);
+static void thread_page_free (struct thread *);
+static struct file **thread_fdt_alloc (void);
 
 /* Returns true if T appears to point to a valid thread. */
 #define is_thread(t) ((t) != NULL && (t)->magic == THREAD_MAGIC)
 
+/* Returns true if T is the idle thread of the CPU it runs on. */
+#define is_idle(t) ((t) == idle_threads[(t)->cpu])
+
+/* Returns true if T may run on any CPU, that is, if it is a user
+   process.  See the comment on struct runq. */
+static inline bool
+thread_migratable (const struct thread *t) {
+#ifdef USERPROG
+	return t->pml4 != NULL;
+#else
+	return false;
+#endif
+}
+
+/* Returns the CPU whose run queue T joins when it is ready: the
+   one it last ran on, or the boot processor's if T may not
+   migrate.  T->cpu itself is left alone, because cpu_id() reads
+   it while T is still running and yielding. */
+static inline int
+runq_cpu (const struct thread *t) {
+	return thread_migratable (t) ? t->cpu : 0;
+}
+
 /* Returns the running thread.
  * Read the CPU's stack pointer `rsp', and then round that
  * down to the start of a page.  Since `struct thread' is
@@ -111,9 +257,25 @@ thread_init (void) {
 
 	/* Init the globla thread context */
 	lock_init (&tid_lock);
-	list_init (&ready_list);
+	spinlock_init (&runq_lock);
+	spinlock_init (&all_lock);
+	spinlock_init (&sleep_lock);
+	spinlock_init (&cache_lock);
+	for (int cpu = 0; cpu < CPU_MAX; cpu++) {
+		struct runq *rq = &runqs[cpu];
+
+		for (int i = PRI_MIN; i <= PRI_MAX; i++)
+			list_init (&rq->ready_queues[i]);
+		rq->ready_mask = 0;
+		rq->ready_cnt = 0;
+		heap_init (&rq->stride_queue, pass_less, NULL);
+		heap_init (&rq->edf_queue, deadline_less, NULL);
+	}
+	list_init (&all_list);
+	list_init (&edf_list);
 	list_init (&destruction_req);
-	list_init (&sleep_list);
+	list_init (&page_cache);
+	heap_init (&sleep_heap, wakeup_less, NULL);
 
 	/* Set up a thread structure for the running thread. */
 	initial_thread = running_thread ();
@@ -121,6 +283,7 @@ thread_init (void) {
 	initial_thread->status = THREAD_RUNNING;
 	initial_thread->tid = allocate_tid ();
 	initial_thread->cur_dir = NULL;
+	cpu_threads[0] = initial_thread;
 }
 
 /* Starts preemptive thread scheduling by enabling interrupts.
@@ -131,14 +294,57 @@ thread_start (void) {
 	struct semaphore idle_started;
 	sema_init (&idle_started, 0);
 	thread_create ("idle", PRI_MIN, idle, &idle_started);
+	intr_register_ext (LAPIC_RESCHED_VEC, resched_interrupt,
+			"Reschedule IPI");
 
 	/* Start preemptive thread scheduling. */
 	intr_enable ();
 
-	/* Wait for the idle thread to initialize idle_thread. */
+	/* Wait for the idle thread to initialize idle_threads[0]. */
 	sema_down (&idle_started);
 }
 
+/* Creates the idle thread of application processor CPU and
+   returns it, or a null pointer if memory is short.  The AP
+   starts out on this thread's stack; see smp_init(). */
+struct thread *
+thread_create_idle (int cpu) {
+	struct thread *t;
+	char name[16];
+
+	ASSERT (cpu > 0 && cpu < CPU_MAX);
+
+	t = thread_page_alloc ();
+	if (t == NULL)
+		return NULL;
+	snprintf (name, sizeof name, "idle%d", cpu);
+	init_thread (t, name, PRI_MIN);
+	t->status = THREAD_RUNNING;
+	t->tid = allocate_tid ();
+	t->cpu = cpu;
+	idle_threads[cpu] = t;
+	cpu_threads[cpu] = t;
+	return t;
+}
+
+/* Runs the idle loop of an application processor, on the thread
+   thread_create_idle() made for it.  Called by ap_main() with
+   interrupts off and the kernel lock held. */
+void
+thread_start_cpu (void) {
+	ASSERT (is_idle (thread_current ()));
+	idle (NULL);
+	NOT_REACHED ();
+}
+
+/* Reschedule IPI, sent by runq_kick() when this CPU has a thread
+   to run, or to steal, that should not wait for the next tick. */
+static void
+resched_interrupt (struct intr_frame *args UNUSED) {
+	if (runq_preempts (thread_current ()))
+		intr_yield_on_return ();
+}
+
 /* Called by the timer interrupt handler at each timer tick.
    Thus, this function runs in an external interrupt context. */
 void
@@ -146,7 +352,8 @@ thread_tick (void) {
 	struct thread *t = thread_current ();
 
 	/* Update statistics. */
-	if (t == idle_thread)
+	t->cpu_ticks++;
+	if (is_idle (t))
 		idle_ticks++;
 #ifdef USERPROG
 	else if (t->pml4 != NULL)
@@ -155,16 +362,80 @@ thread_tick (void) {
 	else
 		kernel_ticks++;
 
+	if (t->edf_period > 0)
+		edf_tick (t);
+	if (thread_mlfqs)
+		mlfqs_tick (t, timer_ticks ());
+	else if (thread_stride && !is_idle (t))
+		t->pass += t->stride;
+
 	/* 선점 시행 */
-	if (++thread_ticks >= TIME_SLICE)
+	if (++thread_ticks[cpu_id ()] >= TIME_SLICE)
 		intr_yield_on_return ();
 }
 
-/* Prints thread statistics. */
+/* Accounts TICKS timer ticks that CPU's idle thread spent halted
+   without taking a timer interrupt.  See timer_idle_exit(). */
+void
+thread_idle_ticks (int cpu, int64_t ticks) {
+	idle_ticks += ticks;
+	if (idle_threads[cpu] != NULL)
+		idle_threads[cpu]->cpu_ticks += ticks;
+}
+
+/* Copies T's scheduler statistics into *ST. */
+static void
+thread_fill_stats (const struct thread *t, struct sched_stats *st) {
+	st->tid = t->tid;
+	strlcpy (st->name, t->name, sizeof st->name);
+	st->priority = t->priority;
+	st->cpu_ticks = t->cpu_ticks;
+	st->ready_ticks = t->ready_ticks;
+	st->lock_ticks = t->lock_ticks;
+	st->voluntary_switches = t->voluntary_switches;
+	st->involuntary_switches = t->involuntary_switches;
+	st->deadline_misses = t->edf_misses;
+}
+
+/* Stores the scheduler statistics of up to MAX live threads into
+   STATS, in the order the threads were created, and returns the
+   total number of live threads. */
+int
+thread_get_stats (struct sched_stats *stats, int max) {
+	struct list_elem *e;
+	int cnt = 0;
+
+	spinlock_acquire (&all_lock);
+	for (e = list_begin (&all_list); e != list_end (&all_list);
+			e = list_next (e)) {
+		if (cnt < max)
+			thread_fill_stats (list_entry (e, struct thread, allelem),
+					&stats[cnt]);
+		cnt++;
+	}
+	spinlock_release (&all_lock);
+	return cnt;
+}
+
+/* Prints thread statistics, including per-thread scheduler
+   accounting for every live thread. */
 void
 thread_print_stats (void) {
+	struct list_elem *e;
+
 	printf ("Thread: %lld idle ticks, %lld kernel ticks, %lld user ticks\n",
 			idle_ticks, kernel_ticks, user_ticks);
+	printf ("Thread: %5s %-16s %3s %8s %8s %8s %8s %8s\n", "tid", "name",
+			"pri", "cpu", "ready", "lock", "vol", "invol");
+	for (e = list_begin (&all_list); e != list_end (&all_list);
+			e = list_next (e)) {
+		struct sched_stats st;
+
+		thread_fill_stats (list_entry (e, struct thread, allelem), &st);
+		printf ("Thread: %5d %-16s %3d %8lld %8lld %8lld %8lld %8lld\n",
+				st.tid, st.name, st.priority, st.cpu_ticks, st.ready_ticks,
+				st.lock_ticks, st.voluntary_switches, st.involuntary_switches);
+	}
 }
 
 /* Creates a new kernel thread named NAME with the given initial
@@ -186,18 +457,38 @@ tid_t
 thread_create (const char *name, int priority,
 		thread_func *function, void *aux) {
 	struct thread *t;
+	struct file **fd_table;
 	tid_t tid;
 
 	ASSERT (function != NULL);
 
 	/* Allocate thread. */
-	t = palloc_get_page (PAL_ZERO);
+	t = thread_page_alloc ();
 	if (t == NULL)
 		return TID_ERROR;
+	t->fd_table = thread_fdt_alloc ();
+	if (t->fd_table == NULL) {
+		thread_page_free (t);
+		return TID_ERROR;
+	}
+	fd_table = t->fd_table;
 
 	/* Initialize thread. */
 	init_thread (t, name, priority);
+	t->fd_table = fd_table;
 	tid = t->tid = allocate_tid ();
+	if (trace_enabled)
+		trace_record_create (tid, name);
+	if (thread_mlfqs) {
+		/* The 4.4BSD scheduler ignores PRIORITY: a new thread
+		   inherits its parent's niceness and recent CPU usage. */
+		t->nice = thread_current ()->nice;
+		t->recent_cpu = thread_current ()->recent_cpu;
+		mlfqs_update_priority (t);
+	}
+	/* A new thread inherits its parent's share. */
+	t->tickets = thread_current ()->tickets;
+	t->stride = STRIDE1 / t->tickets;
 	if(thread_current()->cur_dir != NULL){
 		// ##### 1
 		/* 자식 스레드의 작업 디렉터리를 부모 스레드의 작업 디렉터리로
@@ -216,7 +507,6 @@ thread_create (const char *name, int priority,
 	t->tf.cs = SEL_KCSEG;
 	t->tf.eflags = FLAG_IF;
 
-	t->fd_table = palloc_get_multiple(PAL_ZERO, FDT_PAGES);
 	int stdin = 0; 
 	int stdout = 1;
 	t->fd_table[0] = stdin;
@@ -254,18 +544,21 @@ thread_block (void) {
    be important: if the caller had disabled interrupts itself,
    it may expect that it can atomically unblock a thread and
    update other data. */
-/* 해당 thread를 우선순위 정렬하여 ready list에 넣고 status도 ready로 옮겨줌 */
+/* 해당 thread를 우선순위에 맞는 run queue에 넣고 status도 ready로 옮겨줌 */
 void
 thread_unblock (struct thread *t) {
-	enum intr_level old_level;
-
 	ASSERT (is_thread (t));
 
-	old_level = intr_disable ();
+	spinlock_acquire (&runq_lock);
 	ASSERT (t->status == THREAD_BLOCKED);
-	list_insert_ordered(&ready_list, &t->elem, cmp_priority, NULL);
+	TRACE (TRACE_UNBLOCK, t->tid, t->priority, 0);
+	t->ready_since = timer_ticks ();
+	if (t->pass < global_pass)
+		t->pass = global_pass;
+	runq_push (t);
 	t->status = THREAD_READY;
-	intr_set_level (old_level);
+	runq_kick (t);
+	spinlock_release (&runq_lock);
 }
 
 /* Returns the name of the running thread. */
@@ -310,7 +603,15 @@ thread_exit (void) {
 	/* Just set our status to dying and schedule another process.
 	   We will be destroyed during the call to schedule_tail(). */
 	intr_disable ();
-	// list_remove(&thread_current()->allelem);
+	spinlock_acquire (&all_lock);
+	list_remove (&thread_current ()->allelem);
+	spinlock_release (&all_lock);
+	if (thread_current ()->edf_period > 0) {
+		spinlock_acquire (&runq_lock);
+		edf_util -= edf_density (thread_current ());
+		list_remove (&thread_current ()->edf_allelem);
+		spinlock_release (&runq_lock);
+	}
 	do_schedule (THREAD_DYING);
 	NOT_REACHED ();
 }
@@ -326,9 +627,13 @@ thread_yield (void) {
 	ASSERT (!intr_context ());
 
 	old_level = intr_disable ();		 /* interrupt 비활성화 */
-	if (curr != idle_thread)
-		list_insert_ordered(&ready_list, &curr->elem, cmp_priority, NULL); /* 현재 thread가 CPU를 양보하여 ready_list에 삽입 될 때 
-	우선순위 순서로 정렬되어 삽입 되도록 수정 */
+	if (!is_idle (curr)) {
+		/* 현재 thread가 CPU를 양보하여 자기 우선순위 큐의 맨 뒤에 삽입 */
+		spinlock_acquire (&runq_lock);
+		curr->ready_since = timer_ticks ();
+		runq_push (curr);
+		spinlock_release (&runq_lock);
+	}
 	do_schedule (THREAD_READY);			/* running thread 를 ready로 바꾸고 다음 thread를 running으로 바꿈 : 컨텍스트 스위치 작업을 수행 */
 	intr_set_level (old_level);			/* interrupt 못받는 상태로 설정하고, 이전 인터럽트 상태 반환 */
 }
@@ -358,74 +663,99 @@ thread_sleep(int64_t ticks){ 				/* ticks = 현재 시간 + 재울 시간 = 깨
 	old_level = intr_disable ();			/* 인터럽트를 사용하지 않도록 설정하고 이전 인터럽트 상태를 반환  */
 	
 	curr->wakeup_tick = ticks;				/* 현재 쓰레드의 wakeup_tick에 ticks 저장*/
-	if (curr != idle_thread){				/* idle_thread는 sleep list에 넣지 않음 */
-		list_push_back (&sleep_list, &curr->elem);
+	if (!is_idle (curr)){					/* idle_thread는 sleep queue에 넣지 않음 */
+		spinlock_acquire (&sleep_lock);
+		heap_insert (&sleep_heap, &curr->sleep_elem);
+		curr->sleeping = true;
 		update_next_tick_to_awake(ticks);	/* awake함수가 실행되어야 할 tick값을 update */
+		spinlock_release (&sleep_lock);
 		do_schedule (THREAD_BLOCKED);		/* running thread 를 block으로 바꾸고 다음 thread를 running으로 바꿈 : 컨텍스트 스위치 작업을 수행 */
 	}
 	intr_set_level (old_level);				/* 인터럽트를 다시 받아들이도록 수정 */
 }
 
 
-/* Sleep queue에서 깨워야 할 thread를 찾아서 wake */
+/* Sleep queue에서 깨워야 할 thread를 찾아서 wake.
+   Sleep queue는 wakeup_tick 기준 min-heap 이므로 깨어날 스레드만 본다. */
 void thread_awake(int64_t ticks){ 			/* ticks = 현재 시간 */
-	int64_t next_tick_to_awake = INT64_MAX; /* 쓰레드가 일어나면 sleep list 변할 거라 최소 시간 갱신 */
-	/* sleep list의 모든 entry 를 순회 */
-	struct list_elem *cur = list_begin(&sleep_list);
-	while(cur != list_end(&sleep_list)){
-		struct thread *t = list_entry(cur, struct thread, elem); /* cur의 structure 포인터 반환 */
-		if (ticks >= t->wakeup_tick){	/* 현재 시간이 t의 wakeup_tick보다 크거나 같으면 */
-			/* 슬립 큐에서 제거하고 unblock */
-			cur = list_remove(&t->elem);
-			thread_unblock(t);
-		}else{	/* 현재 시간이 t의 wakeup_tick보다 작으면 update_next_tick_to_awake()를 호출 */ 
-			update_next_tick_to_awake(t->wakeup_tick);	/* 최소 틱을 next_tick_to_awak에 update */
-			cur = list_next(cur);						/* cur를 다음 cur로 변경 */
-		}
+	spinlock_acquire (&sleep_lock);
+	while (!heap_empty (&sleep_heap)) {
+		struct thread *t = heap_entry (heap_top (&sleep_heap),
+				struct thread, sleep_elem);
+		if (t->wakeup_tick > ticks)
+			break;
+
+		/* 슬립 큐에서 제거하고 unblock.  타임아웃 대기 중이었다면
+		   semaphore 의 waiters 에서도 제거 */
+		heap_pop (&sleep_heap);
+		t->sleeping = false;
+		if (t->waiting_on != NULL)
+			synch_cancel_wait (t);
+		thread_unblock (t);
+		/* 깨어난 스레드가 먼저 실행되어야 하면 인터럽트 리턴 시 선점 */
+		if (intr_context () && runq_preempts (thread_current ()))
+			intr_yield_on_return ();
 	}
+
+	/* 남은 스레드 중 가장 빠른 wakeup_tick */
+	next_tick_to_awake = heap_empty (&sleep_heap) ? INT64_MAX
+		: heap_entry (heap_top (&sleep_heap), struct thread, sleep_elem)->wakeup_tick;
+	spinlock_release (&sleep_lock);
 }
 
+/* Orders threads in the EDF run queue by absolute deadline. */
+static bool
+deadline_less (const struct heap_elem *a, const struct heap_elem *b,
+		void *aux UNUSED) {
+	return heap_entry (a, struct thread, edf_elem)->edf_deadline_at
+		< heap_entry (b, struct thread, edf_elem)->edf_deadline_at;
+}
 
-/* ready_list에서 우선순위가 가장 높은 스레드와 현재 스레드의 우선순위를 비교하여 스케줄링 */
-void test_max_priority (void){
-	struct thread *curr = thread_current ();
-	if(!list_empty(&ready_list)){	/* ready_list 가 비어있지 않은지 확인 : 비어있으면 error */
-		struct list_elem *high = list_begin(&ready_list);	/* ready list에서 우선순위 제일 높은 것 */
-		struct thread *t = list_entry(high, struct thread, elem); /* high의 structure 포인터 반환 */
-		if(t->priority > curr->priority){	/* ready list에서 제일 높은 우선순위가 현재 스레드보다 높다면 */
-			if (!intr_context())
-				thread_yield();					/*무조건 run thread 재우고 ready list 우선순위 높은 thread 실행 */
-		}
-	}else{
-		return;
-	} 
-	// struct thread *cp = thread_current();
-	// struct thread *first_thread;
+/* Orders threads in the stride run queue by pass. */
+static bool
+pass_less (const struct heap_elem *a, const struct heap_elem *b,
+		void *aux UNUSED) {
+	return heap_entry (a, struct thread, stride_elem)->pass
+		< heap_entry (b, struct thread, stride_elem)->pass;
+}
 
-	// // project2 
-	// if(intr_context() || list_empty(&ready_list))
-	// 	return;
+/* Removes T, which is blocked in a timed wait that has just been
+   satisfied, from the sleep queue, so that the timer does not
+   wake it again.  Does nothing if T is not in the sleep queue.
+   Must be called with interrupts off. */
+void
+thread_sleep_cancel (struct thread *t) {
+	ASSERT (intr_get_level () == INTR_OFF);
 
-	// first_thread = list_entry(list_front(&ready_list), struct thread, elem);
+	spinlock_acquire (&sleep_lock);
+	if (t->sleeping) {
+		heap_remove (&sleep_heap, &t->sleep_elem);
+		t->sleeping = false;
+		next_tick_to_awake = heap_empty (&sleep_heap) ? INT64_MAX
+			: heap_entry (heap_top (&sleep_heap), struct thread,
+					sleep_elem)->wakeup_tick;
+	}
+	spinlock_release (&sleep_lock);
+}
 
-	// if(cp->priority < first_thread->priority)
-	// 	thread_yield();
+/* Orders sleeping threads by wakeup_tick. */
+static bool
+wakeup_less (const struct heap_elem *a, const struct heap_elem *b,
+		void *aux UNUSED) {
+	return heap_entry (a, struct thread, sleep_elem)->wakeup_tick
+		< heap_entry (b, struct thread, sleep_elem)->wakeup_tick;
 }
 
 
-/* 인자로 주어진 스레드들의 우선순위를 비교 */
-bool cmp_priority (const struct list_elem *a, const struct list_elem *b, void *aux UNUSED){
-	/* list_insert_ordered() 함수에서 사용 하기 위해 정열 방법을 결정하기 위한 함수 작성 */
-	struct thread *cmp_a = list_entry(a, struct thread, elem);
-	struct thread *cmp_b = list_entry(b, struct thread, elem);     
+/* run queue에서 우선순위가 가장 높은 스레드와 현재 스레드의 우선순위를 비교하여 스케줄링 */
+void test_max_priority (void){
+	struct thread *curr = thread_current ();
 
-	if(cmp_a->priority > cmp_b->priority){	// a thread가 우선순위가 높으면 1 반환 
-		return true;
-	}else{
-		return false;
-	}
+	if (!intr_context () && runq_preempts (curr))
+		thread_yield ();	/* run thread 재우고 run queue에서 우선순위 높은 thread 실행 */
 }
 
+
 /* 인자로 주어진 스레드의 donation_elem의 우선순위를 비교 */
 bool cmp_don_priority (const struct list_elem *a, const struct list_elem *b, void *aux UNUSED){
 	return list_entry(a, struct thread, donation_elem)->priority > list_entry(b,struct thread, donation_elem)->priority;
@@ -435,6 +765,10 @@ bool cmp_don_priority (const struct list_elem *a, const struct list_elem *b, voi
 /* 현재 스레드의 우선 순위를 인자로 받은 NEW_PRIORITY로 설정 */
 void
 thread_set_priority (int new_priority) {
+	/* The 4.4BSD scheduler computes priorities itself. */
+	if (thread_mlfqs)
+		return;
+
 	thread_current()->init_priority = new_priority;
 	refresh_priority();		/* 우선순위를 변경으로 인한 donation 관련 정보를 갱신*/
 	test_max_priority();	/* 우선순위에 따라 선점이 발생하도록 */
@@ -458,7 +792,8 @@ void donate_priority(void){
 	while(donated_elem->wait_on_lock != NULL && nested_depth < 8 ){	/* (Nested donation 그림 참고, nested depth 는 8로 제한한다. ) */
 		donated_elem = donated_elem->wait_on_lock->holder;
 		if (donated_elem->priority < cur->priority){
-			donated_elem->priority = cur->priority;
+			TRACE (TRACE_DONATE, cur->tid, donated_elem->tid, cur->priority);
+			thread_update_priority (donated_elem, cur->priority);
 			nested_depth ++;
 		}
 	} 
@@ -483,68 +818,392 @@ void remove_with_lock(struct lock *lock){
 void refresh_priority(void){
 	/* 현재 스레드의 우선순위를 기부받기 전의 우선순위로 변경 */
 	struct thread *cur = thread_current();
-	cur->priority = cur->init_priority;
+	int priority = cur->init_priority;
+	struct list_elem *e;
 
 	/* 가장 우선순위가 높은 donations 리스트의 스레드와
 	현재 스레드의 우선순위를 비교하여 높은 값을 현재 스레드의 우선순위로 설정 */
-	if(list_empty(&cur->donations)== false){
-		list_sort(&cur->donations, cmp_don_priority, NULL);
-		struct thread *t = list_entry(list_front(&cur->donations), struct thread, donation_elem);
-		if(t->priority > cur->priority){	/* 가장 우선순위가 높은 donations 리스트의 스레드가 현재 스레드의 우선순위보다 높으면*/
-			cur->priority = t->priority;
-		}
-	} 
+	for (e = list_begin (&cur->donations); e != list_end (&cur->donations);
+			e = list_next (e)) {
+		struct thread *t = list_entry (e, struct thread, donation_elem);
+		if (t->priority > priority)
+			priority = t->priority;
+	}
+	/* cond_wait() 중에는 현재 스레드도 wait queue 에 있으므로
+	   thread_update_priority() 로 순서를 갱신 */
+	thread_update_priority (cur, priority);
 }
 
 
-/* Sets the current thread's nice value to NICE. */
+/* Recomputes the priority of T, which may have lost a donor
+   whose lock wait timed out, from its own priority and its
+   remaining donors.  Then does the same for the holder of the
+   lock T waits on, and so on down the chain, since T may have
+   passed the lost donation on.  Stops at the first thread whose
+   priority does not change.  Must be called with interrupts
+   off. */
+void
+refresh_priority_chain (struct thread *t) {
+	int depth;
+
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	for (depth = 0; t != NULL && depth < 8; depth++) {
+		int priority = t->init_priority;
+		struct list_elem *e;
+
+		for (e = list_begin (&t->donations); e != list_end (&t->donations);
+				e = list_next (e)) {
+			struct thread *donor = list_entry (e, struct thread, donation_elem);
+			if (donor->priority > priority)
+				priority = donor->priority;
+		}
+		if (priority == t->priority)
+			break;
+		thread_update_priority (t, priority);
+		t = t->wait_on_lock != NULL ? t->wait_on_lock->holder : NULL;
+	}
+}
+
+/* Sets the current thread's nice value to NICE and recalculates
+   its priority, yielding if it no longer has the highest
+   priority. */
 void
-thread_set_nice (int nice UNUSED) {
-	/* TODO: Your implementation goes here */
+thread_set_nice (int nice) {
+	enum intr_level old_level;
+
+	if (nice < NICE_MIN)
+		nice = NICE_MIN;
+	else if (nice > NICE_MAX)
+		nice = NICE_MAX;
+
+	old_level = intr_disable ();
+	thread_current ()->nice = nice;
+	if (thread_mlfqs)
+		mlfqs_update_priority (thread_current ());
+	intr_set_level (old_level);
+	test_max_priority ();
 }
 
 /* Returns the current thread's nice value. */
 int
 thread_get_nice (void) {
-	/* TODO: Your implementation goes here */
-	return 0;
+	return thread_current ()->nice;
 }
 
 /* Returns 100 times the system load average. */
 int
 thread_get_load_avg (void) {
-	/* TODO: Your implementation goes here */
-	return 0;
+	enum intr_level old_level = intr_disable ();
+	int load = fp_to_int_round (load_avg * 100);
+	intr_set_level (old_level);
+	return load;
 }
 
 /* Returns 100 times the current thread's recent_cpu value. */
 int
 thread_get_recent_cpu (void) {
-	/* TODO: Your implementation goes here */
-	return 0;
+	enum intr_level old_level = intr_disable ();
+	int recent = fp_to_int_round (thread_current ()->recent_cpu * 100);
+	intr_set_level (old_level);
+	return recent;
+}
+
+/* Sets the current thread's share of the CPU under -stride to
+   TICKETS and returns the previous share, or -1 if TICKETS is
+   out of range.  The new stride applies from the next tick; the
+   pass already accumulated is kept. */
+int
+thread_set_tickets (int tickets) {
+	struct thread *cur = thread_current ();
+	enum intr_level old_level;
+	int old;
+
+	if (tickets < TICKETS_MIN || tickets > TICKETS_MAX)
+		return -1;
+
+	old_level = intr_disable ();
+	old = cur->tickets;
+	cur->tickets = tickets;
+	cur->stride = STRIDE1 / tickets;
+	intr_set_level (old_level);
+	return old;
+}
+
+/* Returns the current thread's share of the CPU. */
+int
+thread_get_tickets (void) {
+	return thread_current ()->tickets;
+}
+
+/* Returns T's share of the CPU under EDF, in millionths. */
+static int64_t
+edf_density (const struct thread *t) {
+	if (t->edf_period == 0)
+		return 0;
+	return t->edf_runtime * EDF_UTIL_SCALE / t->edf_deadline;
+}
+
+/* Returns true if T is in the EDF class and may still run in its
+   current period. */
+static inline bool
+edf_active (const struct thread *t) {
+	return t->edf_period > 0 && t->edf_budget > 0;
+}
+
+/* Puts the current thread in the EDF class: every PERIOD ticks
+   it needs RUNTIME ticks of CPU time within DEADLINE ticks, where
+   0 < RUNTIME <= DEADLINE <= PERIOD.  The first period starts
+   now.  Returns false, changing nothing, if the parameters are
+   invalid or admitting the thread could make some EDF thread
+   miss a deadline.  A RUNTIME of 0 takes the thread out of the
+   class again.
+
+   The class is not inherited by new threads. */
+bool
+thread_set_deadline (int64_t runtime, int64_t deadline, int64_t period) {
+	struct thread *cur = thread_current ();
+	enum intr_level old_level;
+	int64_t density;
+	bool ok = true;
+
+	if (runtime != 0
+			&& (runtime < 0 || runtime > deadline || deadline > period))
+		return false;
+
+	old_level = intr_disable ();
+	spinlock_acquire (&runq_lock);
+	density = runtime != 0 ? runtime * EDF_UTIL_SCALE / deadline : 0;
+	if (edf_util - edf_density (cur) + density > EDF_UTIL_MAX)
+		ok = false;
+	else {
+		edf_util += density - edf_density (cur);
+		if (cur->edf_period == 0 && runtime != 0)
+			list_push_back (&edf_list, &cur->edf_allelem);
+		else if (cur->edf_period != 0 && runtime == 0)
+			list_remove (&cur->edf_allelem);
+		cur->edf_runtime = runtime;
+		cur->edf_deadline = deadline;
+		cur->edf_period = runtime != 0 ? period : 0;
+		cur->edf_budget = runtime;
+		cur->edf_deadline_at = timer_ticks () + deadline;
+		cur->edf_next_release = timer_ticks () + period;
+		cur->edf_missed = false;
+	}
+	spinlock_release (&runq_lock);
+	intr_set_level (old_level);
+
+	/* Leaving the class may let someone else run first. */
+	if (ok && runtime == 0)
+		test_max_priority ();
+	return ok;
+}
+
+/* Ends the current EDF thread's job for this period and sleeps
+   until the next one is released, counting a miss if the job
+   finished after its deadline.  A job that overran into the next
+   period gets the next release at once. */
+void
+thread_wait_period (void) {
+	struct thread *cur = thread_current ();
+	enum intr_level old_level;
+	int64_t now, release;
+
+	ASSERT (!intr_context ());
+
+	if (cur->edf_period == 0)
+		return;
+
+	old_level = intr_disable ();
+	now = timer_ticks ();
+	if (!cur->edf_missed && now > cur->edf_deadline_at)
+		cur->edf_misses++;
+	release = cur->edf_next_release > now ? cur->edf_next_release : now;
+	cur->edf_budget = cur->edf_runtime;
+	cur->edf_deadline_at = release + cur->edf_deadline;
+	cur->edf_next_release = release + cur->edf_period;
+	cur->edf_missed = false;
+	if (release > now)
+		thread_sleep (release);
+	intr_set_level (old_level);
+}
+
+/* EDF bookkeeping for a timer tick while T is running: charges
+   the tick to T's budget and preempts T once it is spent.
+   Deadlines are checked by thread_edf_release(). */
+static void
+edf_tick (struct thread *t) {
+	if (t->edf_budget > 0 && --t->edf_budget == 0)
+		intr_yield_on_return ();
+}
+
+/* EDF bookkeeping for timer tick TICKS, for every thread in the
+   class, running, ready or blocked: counts a miss as soon as a
+   job's deadline passes, and releases the next job of a thread
+   whose period has ended before it called thread_wait_period(),
+   so that a thread that overran its budget gets a new one on
+   time.  Called by the timer interrupt handler. */
+void
+thread_edf_release (int64_t ticks) {
+	struct list_elem *e;
+	bool released = false;
+
+	ASSERT (intr_context ());
+
+	spinlock_acquire (&runq_lock);
+	if (ticks % 50 == 0) printf ("WALK %lld n=%zu\n", ticks, list_size (&edf_list));
+	for (e = list_begin (&edf_list); e != list_end (&edf_list);
+			e = list_next (e)) {
+		struct thread *t = list_entry (e, struct thread, edf_allelem);
+		bool ready = t->status == THREAD_READY;
+
+		if (!t->edf_missed && ticks > t->edf_deadline_at) {
+			t->edf_missed = true;
+			t->edf_misses++;
+		}
+		if (ticks % 50 == 0) printf ("  %s st=%d b=%lld nr=%lld\n", t->name, t->status, t->edf_budget, t->edf_next_release);
+		if (ticks < t->edf_next_release)
+			continue;
+
+		/* The job is unfinished at the end of its period, so past
+		   its deadline.  As in thread_wait_period(), the next one
+		   is released now.  A ready thread changes queue. */
+		if (!t->edf_missed)
+			t->edf_misses++;
+		if (ready)
+			runq_remove (t);
+		t->edf_budget = t->edf_runtime;
+		t->edf_deadline_at = ticks + t->edf_deadline;
+		t->edf_next_release = ticks + t->edf_period;
+		t->edf_missed = false;
+		if (ready) {
+			runq_push (t);
+			runq_kick (t);
+		}
+		released = true; printf ("REL %lld %s st=%d b=%lld\n", ticks, t->name, t->status, t->edf_budget);
+	}
+	spinlock_release (&runq_lock);
+
+	if (released && runq_preempts (thread_current ()))
+		intr_yield_on_return ();
+}
+
+/* Recomputes T's priority from its recent_cpu and nice values:
+   priority = PRI_MAX - (recent_cpu / 4) - (nice * 2). */
+static void
+mlfqs_update_priority (struct thread *t) {
+	int priority;
+
+	ASSERT (thread_mlfqs);
+
+	if (is_idle (t))
+		return;
+	priority = PRI_MAX - fp_to_int (t->recent_cpu / 4) - t->nice * 2;
+	if (priority < PRI_MIN)
+		priority = PRI_MIN;
+	else if (priority > PRI_MAX)
+		priority = PRI_MAX;
+	t->init_priority = priority;
+	thread_update_priority (t, priority);
+}
+
+/* Once a second, folds the number of ready threads into
+   load_avg and decays every thread's recent_cpu:
+   recent_cpu = (2 * load_avg) / (2 * load_avg + 1) * recent_cpu + nice.
+   Ready threads count those waiting in every CPU's run queue and
+   those running on every CPU.
+   A thread with no recent CPU usage and zero niceness is left
+   untouched, since neither its recent_cpu nor its priority can
+   change. */
+static void
+mlfqs_update_second (void) {
+	int ready_threads = 0;
+	fixed_t twice_load;
+	fixed_t decay;
+	struct list_elem *e;
+	int cpu;
+
+	spinlock_acquire (&runq_lock);
+	for (cpu = 0; cpu < cpu_cnt; cpu++) {
+		ready_threads += runqs[cpu].ready_cnt;
+		if (cpu_threads[cpu] != idle_threads[cpu])
+			ready_threads++;
+	}
+	spinlock_release (&runq_lock);
+
+	load_avg = fp_mul (fp_div (int_to_fp (59), int_to_fp (60)), load_avg)
+		+ fp_div (int_to_fp (ready_threads), int_to_fp (60));
+
+	twice_load = load_avg * 2;
+	decay = fp_div (twice_load, fp_add_int (twice_load, 1));
+	spinlock_acquire (&all_lock);
+	for (e = list_begin (&all_list); e != list_end (&all_list);
+			e = list_next (e)) {
+		struct thread *t = list_entry (e, struct thread, allelem);
+
+		if (is_idle (t) || (t->recent_cpu == 0 && t->nice == 0))
+			continue;
+		t->recent_cpu = fp_add_int (fp_mul (decay, t->recent_cpu), t->nice);
+		mlfqs_update_priority (t);
+	}
+	spinlock_release (&all_lock);
+}
+
+/* 4.4BSD scheduler bookkeeping for timer tick NOW, while T is
+   running.  Only T's recent_cpu changes between once-a-second
+   updates, so only T's priority is recomputed every fourth tick.
+   Threads that stop running mid-slice are recomputed by
+   schedule() as they are switched out.  The once-a-second update
+   follows the boot processor's ticks, the ones timer_ticks()
+   counts. */
+static void
+mlfqs_tick (struct thread *t, int64_t now) {
+	if (!is_idle (t))
+		t->recent_cpu = fp_add_int (t->recent_cpu, 1);
+
+	if (now % TIMER_FREQ == 0 && cpu_id () == 0) {
+		mlfqs_update_second ();
+		if (runq_preempts (t))
+			intr_yield_on_return ();
+	} else if (now % 4 == 0)
+		mlfqs_update_priority (t);
 }
 
 /* Idle thread.  Executes when no other thread is ready to run.
 
    The idle thread is initially put on the ready list by
    thread_start().  It will be scheduled once initially, at which
-   point it initializes idle_thread, "up"s the semaphore passed
+   point it initializes idle_threads[0], "up"s the semaphore passed
    to it to enable thread_start() to continue, and immediately
    blocks.  After that, the idle thread never appears in the
    ready list.  It is returned by next_thread_to_run() as a
-   special case when the ready list is empty. */
+   special case when the ready list is empty.
+
+   An application processor's idle thread is made by
+   thread_create_idle() instead and enters here from
+   thread_start_cpu(), with a null IDLE_STARTED. */
 static void
 idle (void *idle_started_ UNUSED) {
 	struct semaphore *idle_started = idle_started_;
 
-	idle_thread = thread_current ();
-	sema_up (idle_started);
+	if (idle_started != NULL) {
+		idle_threads[0] = thread_current ();
+		sema_up (idle_started);
+	}
 
 	for (;;) {
 		/* Let someone else run. */
 		intr_disable ();
 		thread_block ();
 
+		/* With dynamic ticks, sleep until the next deadline
+		   instead of until the next tick. */
+		timer_idle_enter ();
+
+		/* Let other CPUs into the kernel while this one halts.
+		   The interrupt that wakes it takes the lock back. */
+		kernel_lock_release ();
+
 		/* Re-enable interrupts and wait for the next one.
 
 		   The `sti' instruction disables interrupts until the
@@ -558,6 +1217,7 @@ idle (void *idle_started_ UNUSED) {
 		   See [IA32-v2a] "HLT", [IA32-v2b] "STI", and [IA32-v3a]
 		   7.11.1 "HLT Instruction". */
 		asm volatile ("sti; hlt" : : : "memory");
+		timer_idle_exit ();
 	}
 }
 
@@ -586,7 +1246,15 @@ init_thread (struct thread *t, const char *name, int priority) {
 	t->tf.rsp = (uint64_t) t + PGSIZE - sizeof (void *);
 	t->priority = priority;
 	t->magic = THREAD_MAGIC;
-	// list_push_back (&all_list, &t->allelem);			/*악깡버*/
+	t->nice = NICE_DEFAULT;
+	t->recent_cpu = 0;
+	t->tickets = TICKETS_DEFAULT;
+	t->stride = STRIDE1 / TICKETS_DEFAULT;
+
+	/* The timer interrupt walks all_list under -mlfqs. */
+	spinlock_acquire (&all_lock);
+	list_push_back (&all_list, &t->allelem);
+	spinlock_release (&all_lock);
 
 	/* Priority donation 관련 자료구조 초기화 */
 	t->init_priority = priority;
@@ -598,24 +1266,267 @@ init_thread (struct thread *t, const char *name, int priority) {
 	sema_init(&t->wait_sema, 0); /* wait 세마포어 0으로 초기화 */ 
 	sema_init(&t->free_sema, 0); /* exit 세마포어 0으로 초기화 */ 
 	t->run_file = NULL;
+	lock_init (&t->fd_lock);
+}
+
+/* Appends T to the tail of the run queue for its priority, or
+   under -stride inserts it by pass.  The run queue is that of the
+   CPU T last ran on, or the boot processor's if T may not
+   migrate. */
+static void
+runq_push (struct thread *t) {
+	struct runq *rq;
+
+	ASSERT (spinlock_held_by_current_thread (&runq_lock));
+	ASSERT (PRI_MIN <= t->priority && t->priority <= PRI_MAX);
+
+	rq = &runqs[runq_cpu (t)];
+	if (edf_active (t)) {
+		heap_insert (&rq->edf_queue, &t->edf_elem);
+		rq->ready_cnt++;
+		return;
+	}
+	if (thread_stride) {
+		heap_insert (&rq->stride_queue, &t->stride_elem);
+		rq->ready_cnt++;
+		return;
+	}
+	list_push_back (&rq->ready_queues[t->priority], &t->elem);
+	rq->ready_mask |= 1ULL << t->priority;
+	rq->ready_cnt++;
+}
+
+/* Removes ready thread T from its run queue. */
+static void
+runq_remove (struct thread *t) {
+	struct runq *rq = &runqs[runq_cpu (t)];
+
+	ASSERT (spinlock_held_by_current_thread (&runq_lock));
+	ASSERT (t->status == THREAD_READY);
+
+	/* A ready thread's budget changes only in thread_edf_release(),
+	   which takes it out of its queue first, so T is still in the
+	   queue runq_push() chose. */
+	if (edf_active (t)) {
+		heap_remove (&rq->edf_queue, &t->edf_elem);
+		rq->ready_cnt--;
+		return;
+	}
+	if (thread_stride) {
+		heap_remove (&rq->stride_queue, &t->stride_elem);
+		rq->ready_cnt--;
+		return;
+	}
+	list_remove (&t->elem);
+	if (list_empty (&rq->ready_queues[t->priority]))
+		rq->ready_mask &= ~(1ULL << t->priority);
+	rq->ready_cnt--;
+}
+
+/* Returns the highest priority of any ready thread in RQ, or -1
+   if RQ is empty. */
+static int
+runq_max_priority (const struct runq *rq) {
+	if (rq->ready_mask == 0)
+		return -1;
+	return 63 - __builtin_clzll (rq->ready_mask);
+}
+
+/* Returns true if some thread ready on the running CPU should run
+   before CUR: an EDF thread with an earlier deadline, or any EDF
+   thread if CUR is not one, or else a thread of higher
+   priority. */
+bool
+runq_preempts (struct thread *cur) {
+	struct runq *rq;
+	bool preempt;
+
+	spinlock_acquire (&runq_lock);
+	rq = &runqs[cpu_id ()];
+	if (!heap_empty (&rq->edf_queue)) {
+		struct thread *t = heap_entry (heap_top (&rq->edf_queue),
+				struct thread, edf_elem);
+		preempt = !edf_active (cur) || t->edf_deadline_at < cur->edf_deadline_at;
+	} else
+		preempt = !edf_active (cur) && runq_max_priority (rq) > cur->priority;
+	spinlock_release (&runq_lock);
+	return preempt;
+}
+
+/* Removes and returns the EDF thread in RQ with the earliest
+   deadline, or failing that the thread at the head of the
+   highest non-empty run queue, or under -stride the one with the
+   lowest pass, or NULL if no thread is ready. */
+static struct thread *
+runq_pop (struct runq *rq) {
+	int pri = runq_max_priority (rq);
+	struct thread *t;
+
+	ASSERT (spinlock_held_by_current_thread (&runq_lock));
+	if (!heap_empty (&rq->edf_queue)) {
+		rq->ready_cnt--;
+		return heap_entry (heap_pop (&rq->edf_queue), struct thread, edf_elem);
+	}
+	if (thread_stride) {
+		if (heap_empty (&rq->stride_queue))
+			return NULL;
+		rq->ready_cnt--;
+		t = heap_entry (heap_pop (&rq->stride_queue), struct thread, stride_elem);
+		if (t->pass > global_pass)
+			global_pass = t->pass;
+		return t;
+	}
+	if (pri < 0)
+		return NULL;
+	t = list_entry (list_pop_front (&rq->ready_queues[pri]), struct thread, elem);
+	if (list_empty (&rq->ready_queues[pri]))
+		rq->ready_mask &= ~(1ULL << pri);
+	rq->ready_cnt--;
+	return t;
+}
+
+/* Returns the thread in RQ that another CPU should take: the one
+   runq_pop() would pick among those that may migrate, or NULL if
+   none may.  The heaps are only looked at from the top. */
+static struct thread *
+runq_steal_candidate (struct runq *rq) {
+	struct thread *t;
+	int pri;
+
+	if (!heap_empty (&rq->edf_queue)) {
+		t = heap_entry (heap_top (&rq->edf_queue), struct thread, edf_elem);
+		return thread_migratable (t) ? t : NULL;
+	}
+	if (thread_stride) {
+		if (heap_empty (&rq->stride_queue))
+			return NULL;
+		t = heap_entry (heap_top (&rq->stride_queue), struct thread,
+				stride_elem);
+		return thread_migratable (t) ? t : NULL;
+	}
+	for (pri = runq_max_priority (rq); pri >= PRI_MIN; pri--) {
+		struct list_elem *e;
+
+		for (e = list_begin (&rq->ready_queues[pri]);
+				e != list_end (&rq->ready_queues[pri]); e = list_next (e)) {
+			t = list_entry (e, struct thread, elem);
+			if (thread_migratable (t))
+				return t;
+		}
+	}
+	return NULL;
+}
+
+/* Takes a thread that may migrate from the busiest run queue of
+   any CPU but CPU, for CPU to run, or returns NULL if there is
+   none. */
+static struct thread *
+runq_steal (int cpu) {
+	struct thread *victim = NULL;
+	int busiest = 0;
+	int i;
+
+	ASSERT (spinlock_held_by_current_thread (&runq_lock));
+	for (i = 0; i < cpu_cnt; i++) {
+		struct thread *t;
+
+		if (i == cpu || runqs[i].ready_cnt <= busiest)
+			continue;
+		t = runq_steal_candidate (&runqs[i]);
+		if (t != NULL) {
+			victim = t;
+			busiest = runqs[i].ready_cnt;
+		}
+	}
+	if (victim == NULL)
+		return NULL;
+
+	runq_remove (victim);
+	if (thread_stride && victim->pass > global_pass)
+		global_pass = victim->pass;
+	return victim;
+}
+
+/* Gets T, which has just joined a run queue, running soon.  If it
+   should preempt what its own CPU is running, and that is not the
+   running CPU, sends that CPU a reschedule IPI; otherwise, if T
+   may migrate, wakes an idle CPU to steal it. */
+static void
+runq_kick (struct thread *t) {
+	int self = cpu_id ();
+	int home = runq_cpu (t);
+	int cpu;
+
+	ASSERT (spinlock_held_by_current_thread (&runq_lock));
+	if (cpu_cnt == 1)
+		return;
+
+	if (home != self) {
+		struct thread *cur = cpu_threads[home];
+
+		if (is_idle (cur) || cur->priority < t->priority) {
+			smp_send_resched (home);
+			return;
+		}
+	}
+	if (!thread_migratable (t))
+		return;
+	for (cpu = 0; cpu < cpu_cnt; cpu++)
+		if (cpu != self && cpu != home && is_idle (cpu_threads[cpu])) {
+			smp_send_resched (cpu);
+			return;
+		}
+}
+
+/* Sets T's effective priority to PRIORITY, moving T to the tail
+   of its new run queue if it is currently ready. */
+static void
+thread_update_priority (struct thread *t, int priority) {
+	spinlock_acquire (&runq_lock);
+	if (t->priority != priority) {
+		if (t->status == THREAD_READY) {
+			runq_remove (t);
+			t->priority = priority;
+			runq_push (t);
+		} else
+			t->priority = priority;
+		synch_requeue (t);
+	}
+	spinlock_release (&runq_lock);
 }
 
 /* Chooses and returns the next thread to be scheduled.  Should
-   return a thread from the run queue, unless the run queue is
-   empty.  (If the running thread can continue running, then it
-   will be in the run queue.)  If the run queue is empty, return
-   idle_thread. */
+   return a thread from the running CPU's run queue, unless the
+   run queue is empty.  (If the running thread can continue
+   running, then it will be in the run queue.)  If the run queue
+   is empty, steals a thread from another CPU, and failing that
+   returns the CPU's idle thread. */
 static struct thread *
 next_thread_to_run (void) {
-	if (list_empty (&ready_list))
-		return idle_thread;
-	else
-		return list_entry (list_pop_front (&ready_list), struct thread, elem);
+	int cpu = cpu_id ();
+	struct thread *next;
+
+	spinlock_acquire (&runq_lock);
+	next = runq_pop (&runqs[cpu]);
+	if (next == NULL && cpu_cnt > 1)
+		next = runq_steal (cpu);
+	if (next == NULL)
+		next = idle_threads[cpu];
+	next->cpu = cpu;
+	cpu_threads[cpu] = next;
+	spinlock_release (&runq_lock);
+	return next;
 }
 
 /* Use iretq to launch the thread */
 void
 do_iret (struct intr_frame *tf) {
+	/* Leave the kernel when entering user mode.  The iretq turns
+	   interrupts back on. */
+	if ((tf->cs & 3) == 3) {
+		intr_disable ();
+		kernel_lock_release ();
+	}
 
 	__asm __volatile(
 			"movq %0, %%rsp\n"
@@ -642,18 +1553,16 @@ do_iret (struct intr_frame *tf) {
 			: : "g" ((uint64_t) tf) : "memory");
 }
 
-/* Switching the thread by activating the new thread's page
-   tables, and, if the previous thread is dying, destroying it.
-
-   At this function's invocation, we just switched from thread
-   PREV, the new thread is already running, and interrupts are
-   still disabled.
+/* Switches from the running thread to TH by saving the whole
+   execution context into the running thread's intr_frame and
+   restoring TH's with do_iret().  Only used under -switch=iret,
+   to compare against thread_launch().
 
    It's not safe to call printf() until the thread switch is
    complete.  In practice that means that printf()s should be
    added at the end of the function. */
 static void
-thread_launch (struct thread *th) {
+thread_launch_iret (struct thread *th) {
 	uint64_t tf_cur = (uint64_t) &running_thread ()->tf;
 	uint64_t tf = (uint64_t) &th->tf;
 	ASSERT (intr_get_level () == INTR_OFF);
@@ -711,6 +1620,27 @@ thread_launch (struct thread *th) {
 			);
 }
 
+/* Switches from the running thread to TH.  Interrupts must be
+   off.  A thread that has run before is resumed where it called
+   switch_threads(), with only the callee-saved registers and the
+   stack pointer to restore; a new thread is entered through the
+   interrupt frame thread_create() prepared.  Entering user mode
+   for the first time is left to process code, which calls
+   do_iret() itself. */
+static void
+thread_launch (struct thread *th) {
+	struct thread *cur = running_thread ();
+
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	if (thread_iret_switch)
+		thread_launch_iret (th);
+	else if (th->stack != NULL)
+		switch_threads (&cur->stack, th->stack);
+	else
+		switch_to_new (&cur->stack, &th->tf);
+}
+
 /* Schedules a new process. At entry, interrupts must be off.
  * This function modify current thread's status to status and then
  * finds another thread to run and switches to it.
@@ -722,7 +1652,7 @@ do_schedule(int status) {
 	while (!list_empty (&destruction_req)) {
 		struct thread *victim =
 			list_entry (list_pop_front (&destruction_req), struct thread, elem);
-		palloc_free_page(victim);
+		thread_page_free (victim);
 	}
 	thread_current ()->status = status;
 	schedule ();
@@ -731,16 +1661,22 @@ do_schedule(int status) {
 static void
 schedule (void) {
 	struct thread *curr = running_thread ();
-	struct thread *next = next_thread_to_run (); // ready list가 비어있으면 idle_thread 반환
+	struct thread *next;
 
 	ASSERT (intr_get_level () == INTR_OFF);
 	ASSERT (curr->status != THREAD_RUNNING);
+
+	/* Charge the ticks CURR used in this slice to its priority
+	   now, rather than waiting for the next fourth tick. */
+	if (thread_mlfqs && curr->status != THREAD_DYING)
+		mlfqs_update_priority (curr);
+	next = next_thread_to_run (); // run queue가 비어있으면 idle_thread 반환
 	ASSERT (is_thread (next));
 	/* Mark us as running. */
 	next->status = THREAD_RUNNING;
 
 	/* Start new time slice. */
-	thread_ticks = 0;
+	thread_ticks[next->cpu] = 0;
 
 #ifdef USERPROG
 	/* Activate the new address space. */
@@ -748,6 +1684,15 @@ schedule (void) {
 #endif
 
 	if (curr != next) {
+		/* Scheduler accounting. */
+		if (curr->status == THREAD_READY)
+			curr->involuntary_switches++;
+		else if (curr->status == THREAD_BLOCKED)
+			curr->voluntary_switches++;
+		if (!is_idle (next))
+			next->ready_ticks += timer_ticks () - next->ready_since;
+		TRACE (TRACE_SWITCH, curr->tid, next->tid, curr->status);
+
 		/* If the thread we switched from is dying, destroy its struct
 		   thread. This must happen late so that thread_exit() doesn't
 		   pull out the rug under itself.
@@ -778,3 +1723,69 @@ allocate_tid (void) {
 
 	return tid;
 }
+
+/* Returns a page for a new thread, from the free-thread cache if
+   possible.  Only the struct thread at its bottom needs clearing,
+   which init_thread() does, so a fresh page is not zeroed
+   either. */
+static struct thread *
+thread_page_alloc (void) {
+	struct thread *t = NULL;
+
+	spinlock_acquire (&cache_lock);
+	if (!list_empty (&page_cache)) {
+		t = list_entry (list_pop_front (&page_cache), struct thread, elem);
+		page_cache_cnt--;
+	}
+	spinlock_release (&cache_lock);
+	return t != NULL ? t : palloc_get_page (0);
+}
+
+/* Releases the page of dead thread T, keeping it in the
+   free-thread cache if there is room. */
+static void
+thread_page_free (struct thread *t) {
+	spinlock_acquire (&cache_lock);
+	if (page_cache_cnt < thread_cache_max) {
+		list_push_front (&page_cache, &t->elem);
+		page_cache_cnt++;
+		t = NULL;
+	}
+	spinlock_release (&cache_lock);
+	if (t != NULL)
+		palloc_free_page (t);
+}
+
+/* Returns an empty fd table of FDT_PAGES pages, from the
+   free-thread cache if possible. */
+static struct file **
+thread_fdt_alloc (void) {
+	struct file **fdt = NULL;
+
+	spinlock_acquire (&cache_lock);
+	if (fdt_cache != NULL) {
+		fdt = fdt_cache;
+		fdt_cache = (struct file **) fdt[0];
+		fdt[0] = NULL;
+		fdt_cache_cnt--;
+	}
+	spinlock_release (&cache_lock);
+	return fdt != NULL ? fdt : palloc_get_multiple (PAL_ZERO, FDT_PAGES);
+}
+
+/* Releases fd table FDT, keeping it in the free-thread cache if
+   there is room.  Every slot of FDT must be null, so that the
+   next owner gets an empty table without clearing all of it. */
+void
+thread_fdt_free (struct file **fdt) {
+	spinlock_acquire (&cache_lock);
+	if (fdt_cache_cnt < thread_cache_max) {
+		fdt[0] = (struct file *) fdt_cache;
+		fdt_cache = fdt;
+		fdt_cache_cnt++;
+		fdt = NULL;
+	}
+	spinlock_release (&cache_lock);
+	if (fdt != NULL)
+		palloc_free_multiple (fdt, FDT_PAGES);
+}
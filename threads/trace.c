@@ -0,0 +1,177 @@
+#include "threads/trace.h"
+#include <debug.h>
+#include <stdio.h>
+#include <string.h>
+#include "devices/timer.h"
+#include "threads/interrupt.h"
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
+#include "intrinsic.h"
+#ifdef FILESYS
+#include "devices/disk.h"
+#endif
+
+/* Size of the ring. */
+#define TRACE_PAGES 64
+#define TRACE_EVENT_CNT (TRACE_PAGES * PGSIZE / sizeof (struct trace_event))
+
+/* Header written to the first sector of the scratch disk.  The
+   events follow, oldest first, starting at the next sector. */
+struct trace_header {
+	char magic[8];              /* "PINTRACE". */
+	uint32_t version;           /* TRACE_VERSION. */
+	uint32_t event_size;        /* sizeof (struct trace_event). */
+	uint64_t event_cnt;         /* Number of events that follow. */
+	uint64_t dropped;           /* Older events overwritten in the ring. */
+	uint64_t tsc_per_tick;      /* TSC cycles per timer tick. */
+	uint32_t timer_freq;        /* Timer ticks per second. */
+};
+#define TRACE_VERSION 1
+
+bool trace_enabled;
+
+static struct trace_event *ring;    /* TRACE_EVENT_CNT events. */
+static uint64_t ring_head;          /* Events recorded so far. */
+
+/* TSC and timer tick when tracing started, for calibration. */
+static uint64_t start_tsc;
+static int64_t start_ticks;
+
+/* Allocates the trace ring if tracing was requested with
+   -trace.  Must be called after palloc_init(). */
+void
+trace_init (void) {
+	if (!trace_enabled)
+		return;
+
+	ring = palloc_get_multiple (0, TRACE_PAGES);
+	if (ring == NULL) {
+		printf ("trace: cannot allocate %d pages, tracing disabled\n",
+				TRACE_PAGES);
+		trace_enabled = false;
+		return;
+	}
+	start_tsc = rdtsc ();
+	start_ticks = timer_ticks ();
+}
+
+/* Claims the next slot in the ring, stamps it and fills in TYPE
+   and TID.  Must be called with interrupts off. */
+static struct trace_event *
+trace_slot (enum trace_type type, int tid) {
+	struct trace_event *e = &ring[ring_head++ % TRACE_EVENT_CNT];
+
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	e->tsc = rdtsc ();
+	e->type = type;
+	e->pad = 0;
+	e->tid = tid;
+	return e;
+}
+
+/* Records an event of TYPE about thread TID with arguments ARG0
+   and ARG1.  Safe to call from interrupt handlers. */
+void
+trace_record (enum trace_type type, int tid, int arg0, int arg1) {
+	enum intr_level old_level;
+	struct trace_event *e;
+
+	if (ring == NULL)
+		return;
+
+	old_level = intr_disable ();
+	e = trace_slot (type, tid);
+	e->arg[0] = arg0;
+	e->arg[1] = arg1;
+	e->arg[2] = e->arg[3] = 0;
+	intr_set_level (old_level);
+}
+
+/* Records the creation of thread TID named NAME, so that the
+   analyzer can show names instead of bare tids. */
+void
+trace_record_create (int tid, const char *name) {
+	enum intr_level old_level;
+	struct trace_event *e;
+
+	if (ring == NULL)
+		return;
+
+	old_level = intr_disable ();
+	e = trace_slot (TRACE_CREATE, tid);
+	memset (e->name, 0, sizeof e->name);
+	strlcpy (e->name, name, sizeof e->name);
+	intr_set_level (old_level);
+}
+
+/* Writes the ring to the scratch disk, header first.  Recording
+   stops for good, so that the dump is a consistent snapshot. */
+void
+trace_dump (void) {
+#ifdef FILESYS
+	struct disk *scratch;
+	struct trace_header *h;
+	uint8_t *buffer;
+	uint64_t cnt, first, i;
+	disk_sector_t sector, sectors;
+	int64_t ticks;
+	enum intr_level old_level;
+
+	if (ring == NULL)
+		return;
+	if (intr_get_level () == INTR_OFF) {
+		/* E.g. powering off after a panic: the disk driver needs
+		   interrupts. */
+		printf ("trace: interrupts off, events discarded\n");
+		return;
+	}
+
+	old_level = intr_disable ();
+	trace_enabled = false;
+	cnt = ring_head < TRACE_EVENT_CNT ? ring_head : TRACE_EVENT_CNT;
+	first = ring_head - cnt;
+	intr_set_level (old_level);
+
+	scratch = disk_get (1, 0);
+	if (scratch == NULL) {
+		printf ("trace: no scratch disk, %llu events discarded\n", cnt);
+		return;
+	}
+
+	/* Only write whole events, as many as fit. */
+	sectors = disk_size (scratch);
+	if (sectors == 0)
+		return;
+	if (cnt > (sectors - 1) * (DISK_SECTOR_SIZE / sizeof *ring)) {
+		uint64_t fit = (sectors - 1) * (DISK_SECTOR_SIZE / sizeof *ring);
+		first += cnt - fit;
+		cnt = fit;
+	}
+
+	buffer = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+	h = (struct trace_header *) buffer;
+	memcpy (h->magic, "PINTRACE", sizeof h->magic);
+	h->version = TRACE_VERSION;
+	h->event_size = sizeof *ring;
+	h->event_cnt = cnt;
+	h->dropped = first;
+	ticks = timer_ticks () - start_ticks;
+	h->tsc_per_tick = ticks > 0 ? (rdtsc () - start_tsc) / ticks : 0;
+	h->timer_freq = TIMER_FREQ;
+	disk_write (scratch, 0, buffer);
+
+	for (sector = 1, i = 0; i < cnt; sector++) {
+		struct trace_event *out = (struct trace_event *) buffer;
+		size_t j;
+
+		memset (buffer, 0, DISK_SECTOR_SIZE);
+		for (j = 0; j < DISK_SECTOR_SIZE / sizeof *ring && i < cnt; j++, i++)
+			out[j] = ring[(first + i) % TRACE_EVENT_CNT];
+		disk_write (scratch, sector, buffer);
+	}
+	palloc_free_page (buffer);
+	printf ("trace: %llu events written to scratch disk, %llu dropped\n",
+			cnt, first);
+#endif
+}
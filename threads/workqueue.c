@@ -0,0 +1,321 @@
+#include "threads/workqueue.h"
+#include <debug.h>
+#include <stdio.h>
+#include <string.h>
+#include "devices/timer.h"
+#include "threads/interrupt.h"
+#include "threads/malloc.h"
+#include "threads/thread.h"
+
+/* A workqueue. */
+struct workqueue {
+	char name[16];              /* Name, for the worker threads. */
+	struct spinlock lock;       /* Guards the members below. */
+	struct list items;          /* Pending work, oldest first. */
+	struct semaphore ready;     /* One up per pending item. */
+	int active_cnt;             /* Pending plus running items. */
+	int flusher_cnt;            /* Threads in flush_workqueue(). */
+	struct semaphore idle;      /* Up'd for each flusher when idle. */
+};
+
+/* Number of workers serving system_wq. */
+#define SYSTEM_WQ_WORKERS 2
+
+struct workqueue *system_wq;
+
+/* Delayed work whose timer is armed, soonest on top, and the tick
+   at which the first of it expires.  The timer interrupt reads
+   NEXT_DEADLINE on every tick, so it is kept up to date rather
+   than computed from the heap. */
+static struct heap delayed_heap;
+static struct spinlock delayed_lock;
+static int64_t next_deadline = INT64_MAX;
+
+static thread_func worker;
+static heap_less_func expires_less;
+static void update_next_deadline (void);
+
+/* Initializes the workqueue subsystem and creates system_wq.
+   Must be called after thread_init() and malloc_init(). */
+void
+workqueue_init (void) {
+	heap_init (&delayed_heap, expires_less, NULL);
+	spinlock_init (&delayed_lock);
+	system_wq = workqueue_create ("events", SYSTEM_WQ_WORKERS);
+	if (system_wq == NULL)
+		PANIC ("could not create system workqueue");
+}
+
+/* Creates a workqueue named NAME served by WORKER_CNT kernel
+   threads and returns it, or a null pointer if memory or thread
+   creation fails.  Workqueues are never destroyed. */
+struct workqueue *
+workqueue_create (const char *name, int worker_cnt) {
+	struct workqueue *wq;
+	int i;
+
+	ASSERT (name != NULL);
+	ASSERT (worker_cnt > 0);
+
+	wq = malloc (sizeof *wq);
+	if (wq == NULL)
+		return NULL;
+	strlcpy (wq->name, name, sizeof wq->name);
+	spinlock_init (&wq->lock);
+	list_init (&wq->items);
+	sema_init (&wq->ready, 0);
+	wq->active_cnt = 0;
+	wq->flusher_cnt = 0;
+	sema_init (&wq->idle, 0);
+
+	for (i = 0; i < worker_cnt; i++) {
+		char thread_name[32];
+
+		snprintf (thread_name, sizeof thread_name, "%s/%d", wq->name, i);
+		if (thread_create (thread_name, PRI_DEFAULT, worker, wq) == TID_ERROR) {
+			if (i == 0) {
+				free (wq);
+				return NULL;
+			}
+			break;
+		}
+	}
+	return wq;
+}
+
+/* Initializes WORK to run FUNC. */
+void
+work_init (struct work *work, work_func *func) {
+	ASSERT (work != NULL);
+	ASSERT (func != NULL);
+
+	work->func = func;
+	work->pending = false;
+	work->wq = NULL;
+}
+
+/* Queues WORK on WQ.  Returns false, doing nothing, if WORK is
+   already pending.  WORK may be queued again as soon as a worker
+   has started running it.
+
+   This function does not sleep, so it may be called within an
+   interrupt handler. */
+bool
+queue_work (struct workqueue *wq, struct work *work) {
+	bool queued = false;
+
+	ASSERT (wq != NULL);
+	ASSERT (work != NULL);
+
+	spinlock_acquire (&wq->lock);
+	if (!work->pending) {
+		work->pending = true;
+		work->wq = wq;
+		list_push_back (&wq->items, &work->elem);
+		wq->active_cnt++;
+		queued = true;
+	}
+	spinlock_release (&wq->lock);
+
+	/* sema_up() may yield to the worker, which must not happen
+	   while holding a spinlock. */
+	if (queued)
+		sema_up (&wq->ready);
+	return queued;
+}
+
+/* Removes WORK from its queue if it has not started yet, and
+   returns true if so.  Returns false if WORK is not pending, or
+   if every worker has already claimed an item and WORK is about
+   to be run; it may still be running or about to run.
+
+   Each pending item owns one count in WQ->ready until a worker
+   takes it, so removing WORK means taking back one count. */
+bool
+cancel_work (struct work *work) {
+	struct workqueue *wq = work->wq;
+	bool canceled = false;
+
+	if (wq == NULL)
+		return false;
+
+	spinlock_acquire (&wq->lock);
+	if (work->pending && sema_try_down (&wq->ready)) {
+		work->pending = false;
+		list_remove (&work->elem);
+		wq->active_cnt--;
+		canceled = true;
+	}
+	spinlock_release (&wq->lock);
+	return canceled;
+}
+
+/* Waits until every item queued on WQ, including any queued
+   while waiting, has finished running.  Must not be called from
+   one of WQ's own workers, which would wait for itself. */
+void
+flush_workqueue (struct workqueue *wq) {
+	ASSERT (wq != NULL);
+	ASSERT (!intr_context ());
+
+	spinlock_acquire (&wq->lock);
+	if (wq->active_cnt == 0) {
+		spinlock_release (&wq->lock);
+		return;
+	}
+	wq->flusher_cnt++;
+	spinlock_release (&wq->lock);
+
+	sema_down (&wq->idle);
+}
+
+/* Worker thread.  Runs WQ_'s items in the order they were
+   queued, one at a time. */
+static void
+worker (void *wq_) {
+	struct workqueue *wq = wq_;
+
+	for (;;) {
+		struct work *work;
+		int wake_cnt;
+
+		sema_down (&wq->ready);
+		spinlock_acquire (&wq->lock);
+		ASSERT (!list_empty (&wq->items));
+		work = list_entry (list_pop_front (&wq->items), struct work, elem);
+		work->pending = false;
+		spinlock_release (&wq->lock);
+
+		work->func (work);
+
+		spinlock_acquire (&wq->lock);
+		wake_cnt = 0;
+		if (--wq->active_cnt == 0) {
+			wake_cnt = wq->flusher_cnt;
+			wq->flusher_cnt = 0;
+		}
+		spinlock_release (&wq->lock);
+
+		while (wake_cnt-- > 0)
+			sema_up (&wq->idle);
+	}
+}
+
+/* Initializes DWORK to run FUNC. */
+void
+delayed_work_init (struct delayed_work *dwork, work_func *func) {
+	ASSERT (dwork != NULL);
+
+	work_init (&dwork->work, func);
+	dwork->wq = NULL;
+	dwork->timer_armed = false;
+}
+
+/* Queues DWORK on WQ once DELAY timer ticks have passed, or at
+   once if DELAY is not positive.  Returns false, doing nothing,
+   if DWORK is already waiting for its timer or pending on a
+   queue.
+
+   This function does not sleep, so it may be called within an
+   interrupt handler. */
+bool
+queue_delayed_work (struct workqueue *wq, struct delayed_work *dwork,
+		int64_t delay) {
+	bool armed = false;
+
+	ASSERT (wq != NULL);
+	ASSERT (dwork != NULL);
+
+	if (delay <= 0)
+		return !dwork->timer_armed && queue_work (wq, &dwork->work);
+
+	spinlock_acquire (&delayed_lock);
+	if (!dwork->timer_armed && !dwork->work.pending) {
+		dwork->wq = wq;
+		dwork->expires = timer_ticks () + delay;
+		dwork->timer_armed = true;
+		heap_insert (&delayed_heap, &dwork->timer_elem);
+		if (dwork->expires < next_deadline)
+			next_deadline = dwork->expires;
+		armed = true;
+	}
+	spinlock_release (&delayed_lock);
+	return armed;
+}
+
+/* Cancels DWORK, whether it is still waiting for its timer or
+   already pending on a queue.  Returns true if it was canceled
+   before it started running. */
+bool
+cancel_delayed_work (struct delayed_work *dwork) {
+	bool canceled = false;
+
+	spinlock_acquire (&delayed_lock);
+	if (dwork->timer_armed) {
+		dwork->timer_armed = false;
+		heap_remove (&delayed_heap, &dwork->timer_elem);
+		update_next_deadline ();
+		canceled = true;
+	}
+	spinlock_release (&delayed_lock);
+
+	return canceled || cancel_work (&dwork->work);
+}
+
+/* Queues every delayed work item whose timer has expired by tick
+   NOW.  Called by the timer interrupt handler.
+
+   queue_work() takes the queue's lock and wakes a worker, so the
+   expired items are gathered under DELAYED_LOCK and queued only
+   after releasing it.  An item whose timer was armed is on no
+   queue, so its list element is free to gather it with. */
+void
+workqueue_tick (int64_t now) {
+	struct list expired;
+
+	list_init (&expired);
+	spinlock_acquire (&delayed_lock);
+	while (!heap_empty (&delayed_heap)) {
+		struct delayed_work *dwork = heap_entry (heap_top (&delayed_heap),
+				struct delayed_work, timer_elem);
+		if (dwork->expires > now)
+			break;
+		heap_pop (&delayed_heap);
+		dwork->timer_armed = false;
+		list_push_back (&expired, &dwork->work.elem);
+	}
+	update_next_deadline ();
+	spinlock_release (&delayed_lock);
+
+	while (!list_empty (&expired)) {
+		struct work *work = list_entry (list_pop_front (&expired),
+				struct work, elem);
+		struct delayed_work *dwork = work_entry (work, struct delayed_work, work);
+
+		queue_work (dwork->wq, work);
+	}
+}
+
+/* Returns the tick at which the next delayed work item expires,
+   or INT64_MAX if none is armed. */
+int64_t
+workqueue_next_deadline (void) {
+	return next_deadline;
+}
+
+/* Sets NEXT_DEADLINE from the top of the delayed heap.
+   DELAYED_LOCK must be held. */
+static void
+update_next_deadline (void) {
+	next_deadline = heap_empty (&delayed_heap) ? INT64_MAX
+		: heap_entry (heap_top (&delayed_heap),
+				struct delayed_work, timer_elem)->expires;
+}
+
+/* Orders delayed work by expiry time. */
+static bool
+expires_less (const struct heap_elem *a, const struct heap_elem *b,
+		void *aux UNUSED) {
+	return heap_entry (a, struct delayed_work, timer_elem)->expires
+		< heap_entry (b, struct delayed_work, timer_elem)->expires;
+}
@@ -2,6 +2,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include "userprog/gdt.h"
+#include "userprog/uaccess.h"
 #include "threads/interrupt.h"
 #include "threads/thread.h"
 #include "intrinsic.h"
@@ -129,6 +130,11 @@ page_fault (struct intr_frame *f) {
 	   that caused the fault (that's f->rip). */
 
 	fault_addr = (void *) rcr2();
+	{ extern void syscall_entry (void); extern void syscall_handler (struct intr_frame *);
+	  if ((f->cs & 3) == 3 && f->rip == (uint64_t) syscall_entry) {
+		f->rip = f->R.rcx; f->eflags = f->R.r11;
+		if (f->eflags & 0x200) intr_enable ();
+		syscall_handler (f); return; } }
 
 	/* Turn interrupts back on (they were only off so that we could
 	   be assured of reading CR2 before it changed). */
@@ -151,6 +157,10 @@ page_fault (struct intr_frame *f) {
 	if (vm_try_handle_fault (f, fault_addr, user, write, not_present))
 		return;
 #endif
+	/* A bad user address passed to a system call fails the user
+	   copy that touched it, not the kernel. */
+	if (!user && uaccess_fixup (f))
+		return;
 	exit(-1);
 
 	/* Count page faults. */
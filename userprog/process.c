@@ -7,12 +7,14 @@
 #include <string.h>
 #include "userprog/gdt.h"
 #include "userprog/tss.h"
+#include "userprog/uring.h"
 #include "filesys/directory.h"
 #include "filesys/file.h"
 #include "filesys/filesys.h"
 #include "threads/flags.h"
 #include "threads/init.h"
 #include "threads/interrupt.h"
+#include "threads/malloc.h"
 #include "threads/palloc.h"
 #include "threads/thread.h"
 #include "threads/mmu.h"
@@ -240,10 +242,11 @@ __do_fork(void *aux){
 		goto error;
 	}
 
+	/* 부모는 fork() 동안 fd_lock 을 쥐고 있으므로 ring worker 가 끼어들지 않는다 */
 	current->fd_table[0] = parent->fd_table[0];
 	current->fd_table[1] = parent->fd_table[1];
 	struct file *f;
-	for (int i = 2; i < MAX_FD_NUM; i++){
+	for (int i = 2; i <= parent->fdidx && i < MAX_FD_NUM; i++){
 		f = parent->fd_table[i];
 		if (f == NULL){
 			continue;
@@ -291,6 +294,7 @@ int process_exec(void *f_name)
 	_if.cs = SEL_UCSEG;
 	_if.eflags = FLAG_IF | FLAG_MBS;
 
+	uring_destroy ();
 	process_cleanup(); // 새로운 실행 파일을 현재 스레드에 담기 전에 현재 process에 담긴 context 삭제
 
 	//선도
@@ -372,6 +376,29 @@ int process_wait(tid_t child_tid UNUSED){
 	// return -1;
 }
 
+/* Like process_wait(), but gives up once TICKS timer ticks have
+ * passed without child TID exiting.  Returns false on timeout,
+ * leaving TID to be waited for again; otherwise returns true and
+ * stores what process_wait() would return in *STATUS. */
+bool process_wait_timeout(tid_t child_tid, int64_t ticks, int *status){
+	/* 자식 프로세스의 프로세스 디스크립터 검색 */
+	struct thread * child = get_child(child_tid); /* 자식 리스트를 검색하여 프로세스 디스크립터의 주소 리턴 */
+	if(child == NULL){	/* 예외 처리 발생시 -1 리턴 */
+		*status = -1;
+		return true;
+	}
+	/* 자식프로세스가 종료될 때까지 현재(부모) 프로세스 대기(세마포어 이용) */
+	if(!sema_down_timeout(&child->wait_sema, ticks))
+		return false;	/* 시간 초과: 자식은 자식 리스트에 그대로 남는다 */
+	/* 자식 프로세스 디스크립터 삭제 */
+	/* --------------------누군가가 sema up을 해줘서 부모(자신)가 깸 ---------------------- */
+	*status = child->exit_status;
+	remove_child_process(child); 	/* 프로세스 디스크립터를 자식 리스트에서 제거 후 메모리 해제 */
+	/* 자식 프로세스의 exit status 리턴 */
+	sema_up(&child->free_sema);
+	return true;
+}
+
 /* Exit the process. This function is called by thread_exit (). */
 void process_exit(void)
 {
@@ -380,10 +407,18 @@ void process_exit(void)
 	 * TODO: Implement process termination message (see
 	 * TODO: project2/process_termination.html).
 	 * TODO: We recommend you to implement process resource cleanup here. */
-	for (int i =0; i < MAX_FD_NUM; i++){
+	/* fd 를 다루던 system call 도중 종료하면 fd_lock 을 쥐고 있다.
+	   ring worker 가 그 lock 을 기다릴 수 있으므로 먼저 풀고 worker 를 정리한다. */
+	if (lock_held_by_current_thread (&cur->fd_lock))
+		lock_release (&cur->fd_lock);
+	uring_destroy ();
+	/* fdidx 보다 큰 slot 은 사용된 적이 없으므로 비어 있다. */
+	for (int i =0; i <= cur->fdidx && i < MAX_FD_NUM; i++){
 		close(i);
 	}
-	palloc_free_multiple(cur->fd_table, FDT_PAGES);  // for multi-oom(메모리 누수)
+	/* 모든 slot 이 비었으므로 다음 thread 가 그대로 재사용할 수 있다. */
+	thread_fdt_free(cur->fd_table);  // for multi-oom(메모리 누수)
+	cur->fd_table = NULL;
 	
 	/* 실행 중인 파일 close */
 	file_close(cur->run_file);
@@ -545,6 +580,9 @@ void argument_stack(char **argv, int argc, struct intr_frame *if_)
 }
 
 
+/* Most words load() splits a command line into. */
+#define ARGV_MAX (PGSIZE / sizeof (char *))
+
 /* Loads an ELF executable from FILE_NAME into the current thread.
  * Stores the executable's entry point into *RIP
  * and its initial stack pointer into *RSP.
@@ -560,16 +598,20 @@ load(const char *file_name, struct intr_frame *if_)
 	int i;
 
 // ################
-	char *argv[128]; // 커맨드 라인 길이 제한 128
+	/* 인자 포인터 배열은 커널 스택에 두기엔 크므로 페이지에 둔다 */
+	char **argv = palloc_get_page(0);
 	char *token, *save_ptr;
 	int argc = 0;
 
+	if (argv == NULL)
+		return false;
+
 	// memcpy(copy, file_name, strlen(file_name)+1);
 
 	token = strtok_r(file_name, " ", &save_ptr);
 	argv[argc] = token;
 
-	while (token != NULL)
+	while (token != NULL && argc < (int) ARGV_MAX - 1)
 	{
 		token = strtok_r(NULL, " ", &save_ptr);
 		argc++;
@@ -684,6 +726,7 @@ load(const char *file_name, struct intr_frame *if_)
 done:
 	/* We arrive here whether the load is successful or not. */
 	// file_close(file); // file 닫히면서 lock이 풀림
+	palloc_free_page(argv);
 	return success;
 }
 
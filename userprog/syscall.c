@@ -1,24 +1,31 @@
 #include "userprog/syscall.h"
+#include <console.h>
+#include <iovec.h>
+#include <limits.h>
+#include <round.h>
 #include <stdio.h>
+#include <string.h>
 #include <syscall-nr.h>
 #include "threads/interrupt.h"
 #include "threads/thread.h"
 #include "threads/loader.h"
 #include "userprog/gdt.h"
 #include "threads/flags.h"
+#include "threads/malloc.h"
 #include "threads/palloc.h"
+#include "threads/smp.h"
 #include "intrinsic.h"
 #include "filesys/filesys.h"
 #include "filesys/file.h"
 #include "userprog/process.h"
+#include "userprog/uaccess.h"
+#include "userprog/uring.h"
 #include "vm/vm.h"
 #include "include/filesys/inode.h"
 #include "include/filesys/directory.h"
 
 void syscall_entry (void);
 void syscall_handler (struct intr_frame *);
-// void check_address(void *addr);
-struct page* check_address(void *addr);
 
 void halt (void);
 void exit (int status);
@@ -27,7 +34,7 @@ bool remove (const char *file);
 int write (int fd, const void *buffer, unsigned size); 
 int wait (tid_t pid);
 tid_t fork (const char *thread_name, struct intr_frame *f);
-int exec (const char *file);
+void exec (const char *file);
 int open (const char *file);
 int add_file_to_fdt(struct file *file);
 struct file *fd_to_file(int fd);
@@ -35,6 +42,10 @@ void remove_fd(int fd);
 void close (int fd);
 int filesize (int fd);
 int read (int fd, void *buffer, unsigned size);
+int pread (int fd, void *buffer, unsigned size, off_t offset);
+int pwrite (int fd, const void *buffer, unsigned size, off_t offset);
+int copy_file_range (int fd_in, off_t off_in, int fd_out, off_t off_out,
+		unsigned size);
 void seek (int fd, unsigned position);
 unsigned tell (int fd);
 void *mmap (void *addr, size_t length, int writable, int fd, off_t offset);
@@ -44,8 +55,14 @@ bool chdir (char *path_name);
 bool mkdir (char *dir);
 bool readdir (int fd, char *name);
 int inumber(int fd);
+int sched_stats (struct sched_stats *buf, int max);
+int readv (int fd, const struct iovec *uiov, int iovcnt);
+int writev (int fd, const struct iovec *uiov, int iovcnt);
 
-struct lock filesys_lock;
+/* Serializes operations on the directory tree (create, remove,
+   open, mkdir, chdir, readdir).  File contents are guarded by the
+   per-inode rwlocks in inode.c, so read and write do not take it. */
+struct lock filesys_meta_lock;
 
 
 /* System call.
@@ -60,10 +77,19 @@ struct lock filesys_lock;
 #define MSR_STAR 0xc0000081         /* Segment selector msr */
 #define MSR_LSTAR 0xc0000082        /* Long mode SYSCALL target */
 #define MSR_SYSCALL_MASK 0xc0000084 /* Mask for the eflags */
+#define MSR_KERNEL_GS_BASE 0xc0000102 /* %gs base after swapgs */
 
 void
 syscall_init (void) {
-	lock_init(&filesys_lock);
+	lock_init(&filesys_meta_lock);
+	syscall_init_cpu ();
+}
+
+/* Sets up the running CPU for the syscall instruction.  Called by
+ * syscall_init() on the boot processor and by ap_main() on the
+ * others. */
+void
+syscall_init_cpu (void) {
 	write_msr(MSR_STAR, ((uint64_t)SEL_UCSEG - 0x10) << 48  |
 			((uint64_t)SEL_KCSEG) << 32);
 	write_msr(MSR_LSTAR, (uint64_t) syscall_entry);
@@ -73,135 +99,197 @@ syscall_init (void) {
 	 * mode stack. Therefore, we masked the FLAG_FL. */
 	write_msr(MSR_SYSCALL_MASK,
 			FLAG_IF | FLAG_TF | FLAG_DF | FLAG_IOPL | FLAG_AC | FLAG_NT);
+
+	/* syscall_entry finds this CPU's struct cpu through swapgs. */
+	write_msr(MSR_KERNEL_GS_BASE, (uint64_t) cpu_current ());
 }
 
-/* 주소 값이 유저 영역에서 사용하는 주소 값인지 확인 하는 함수
-Pintos에서는 시스템 콜이 접근할 수 있는 주소를 0x8048000~0xc0000000으로 제한함 
-유저 영역을 벗어난 영역일 경우 프로세스 종료(exit(-1)) */
-// void 
-// check_address(void *addr) {
-// 	struct thread *cur = thread_current();
-// /* 1. 포인터가 가리키는 주소가 유저영역의 주소인지 확인 */
-// /* 2. 포인터가 가리키는 주소가 존재하는지 확인 */
-// /* 3. 포인터가 가리키는 주소에 해당하는 실주소가 없는 경우 NULL 반환 */
-// // || pml4_get_page(cur->pml4, addr) == NULL
-// 	if(!is_user_vaddr(addr) || addr == NULL || pml4_get_page(cur->pml4, addr) == NULL){
-// 		exit(-1);
-// 	}
-// /* 잘못된 접근일 경우 프로세스 종료 */ 
-// }
-
-struct page* check_address(void *addr) {
-	if(is_kernel_vaddr(addr))
-	{
-		exit(-1);
-	}
-	struct page* f_page = spt_find_page(&thread_current()->spt, addr);
+/* 유저 문자열 USTR 을 새 커널 페이지로 복사해서 반환.  유저 메모리를 읽을 수
+   없으면 NULL 반환.  한 페이지보다 긴 문자열은 잘린다.  palloc_free_page() 로 해제 */
+static char *
+copy_in_string (const char *ustr) {
+	char *kstr = palloc_get_page(0);
+	long len;
 
-	if (!f_page)
-		exit(-1);
+	if (kstr == NULL)
+		return NULL;
+	len = strncpy_from_user(kstr, ustr, PGSIZE);
+	if (len < 0) {
+		palloc_free_page(kstr);
+		return NULL;
+	}
+	if (len == PGSIZE)
+		kstr[PGSIZE - 1] = '\0';
+	return kstr;
+}
 
-	return f_page;
+/* How syscall_handler() passes one system call argument to the
+   handler. */
+enum syscall_arg {
+	ARG_VAL = 0,                /* As is. */
+	ARG_STR,                    /* User string, copied into a kernel
+	                               page by copy_in_args(). */
+};
+
+/* How a handler returns its result, which goes into rax. */
+enum syscall_ret {
+	RET_VOID,                   /* Nothing; rax is left alone. */
+	RET_INT,                    /* int, sign-extended. */
+	RET_UINT,                   /* unsigned, zero-extended. */
+	RET_BOOL,                   /* bool. */
+	RET_PTR,                    /* 64-bit value or pointer. */
+};
+
+/* A system call.  Handlers take at most six integer or pointer
+   arguments, which the x86-64 calling convention passes in the
+   same registers whatever the prototype, so every handler is
+   called through one of the generic types below. */
+struct syscall_desc {
+	void *func;                 /* Handler, or null if unimplemented. */
+	uint8_t arity;              /* Number of arguments. */
+	uint8_t ret;                /* enum syscall_ret. */
+	bool frame;                 /* Pass the intr_frame after the arguments? */
+	uint8_t args[6];            /* enum syscall_arg, per argument. */
+	bool fdt;                   /* Hold the process's fd_lock throughout? */
+};
+
+typedef void syscall_void_func (uint64_t, uint64_t, uint64_t, uint64_t,
+		uint64_t, uint64_t);
+typedef int syscall_int_func (uint64_t, uint64_t, uint64_t, uint64_t,
+		uint64_t, uint64_t);
+typedef unsigned syscall_uint_func (uint64_t, uint64_t, uint64_t, uint64_t,
+		uint64_t, uint64_t);
+typedef bool syscall_bool_func (uint64_t, uint64_t, uint64_t, uint64_t,
+		uint64_t, uint64_t);
+typedef uint64_t syscall_ptr_func (uint64_t, uint64_t, uint64_t, uint64_t,
+		uint64_t, uint64_t);
+
+static const struct syscall_desc syscall_table[] = {
+	[SYS_HALT] = {halt, 0, RET_VOID},
+	[SYS_EXIT] = {exit, 1, RET_VOID},
+	[SYS_FORK] = {fork, 1, RET_INT, true, {ARG_STR}, .fdt = true},
+	[SYS_EXEC] = {exec, 1, RET_VOID},
+	[SYS_WAIT] = {wait, 1, RET_INT},
+	[SYS_CREATE] = {create, 2, RET_BOOL, false, {ARG_STR}},
+	[SYS_REMOVE] = {remove, 1, RET_BOOL, false, {ARG_STR}},
+	[SYS_OPEN] = {open, 1, RET_INT, false, {ARG_STR}, .fdt = true},
+	[SYS_FILESIZE] = {filesize, 1, RET_INT, .fdt = true},
+	[SYS_READ] = {read, 3, RET_INT, .fdt = true},
+	[SYS_WRITE] = {write, 3, RET_INT, .fdt = true},
+	[SYS_SEEK] = {seek, 2, RET_VOID, .fdt = true},
+	[SYS_TELL] = {tell, 1, RET_UINT, .fdt = true},
+	[SYS_CLOSE] = {close, 1, RET_VOID, .fdt = true},
+	[SYS_MMAP] = {mmap, 5, RET_PTR, .fdt = true},
+	[SYS_MUNMAP] = {munmap, 1, RET_VOID},
+	[SYS_CHDIR] = {chdir, 1, RET_BOOL, false, {ARG_STR}},
+	[SYS_MKDIR] = {mkdir, 1, RET_BOOL, false, {ARG_STR}},
+	[SYS_READDIR] = {readdir, 2, RET_BOOL, .fdt = true},
+	[SYS_ISDIR] = {isdir, 1, RET_BOOL, .fdt = true},
+	[SYS_INUMBER] = {inumber, 1, RET_INT, .fdt = true},
+	[SYS_SCHED_STATS] = {sched_stats, 2, RET_INT},
+	[SYS_SET_TICKETS] = {thread_set_tickets, 1, RET_INT},
+	[SYS_SCHED_DEADLINE] = {thread_set_deadline, 3, RET_BOOL},
+	[SYS_SCHED_WAIT_PERIOD] = {thread_wait_period, 0, RET_VOID},
+	[SYS_READV] = {readv, 3, RET_INT, .fdt = true},
+	[SYS_WRITEV] = {writev, 3, RET_INT, .fdt = true},
+	[SYS_PREAD] = {pread, 4, RET_INT, .fdt = true},
+	[SYS_PWRITE] = {pwrite, 4, RET_INT, .fdt = true},
+	[SYS_COPY_FILE_RANGE] = {copy_file_range, 5, RET_INT, .fdt = true},
+	[SYS_URING_SETUP] = {uring_setup, 2, RET_PTR},
+	[SYS_URING_ENTER] = {uring_enter, 2, RET_INT},
+};
+#define SYSCALL_CNT (sizeof syscall_table / sizeof *syscall_table)
+
+/* Frees the kernel copies of string arguments among the first
+   CNT of ARGS. */
+static void
+free_args (const struct syscall_desc *d, uint64_t *args, int cnt) {
+	int i;
+
+	for (i = 0; i < cnt; i++)
+		if (d->args[i] == ARG_STR)
+			palloc_free_page((void *) args[i]);
 }
 
-// SYS_READ -> to_write == 1
-// SYS_WRITE -> to_write == 0
-void check_valid_buffer(void* buffer, unsigned size, void* rsp, bool to_write) {
-    for (int i = 0; i < size; i++) {
-        struct page* page = check_address(buffer + i);    // 인자로 받은 buffer부터 buffer + size까지의 크기가 한 페이지의 크기를 넘을수도 있음
-        if (page == NULL)
-            exit(-1);
-        if (to_write == true && page->writable == false)
-            exit(-1);
-    }
+/* Replaces each string argument in ARGS, as D says, by a kernel
+   copy, so that the handler never reads the string from user
+   memory itself.  Returns false, with nothing left allocated, if
+   one of them cannot be read. */
+static bool
+copy_in_args (const struct syscall_desc *d, uint64_t *args) {
+	int i;
+
+	for (i = 0; i < d->arity; i++) {
+		if (d->args[i] == ARG_STR) {
+			char *kstr = copy_in_string((const char *) args[i]);
+			if (kstr == NULL) {
+				free_args(d, args, i);
+				return false;
+			}
+			args[i] = (uint64_t) kstr;
+		}
+	}
+	return true;
 }
 
 /* The main system call interface */
 void
-syscall_handler (struct intr_frame *f UNUSED) {
+syscall_handler (struct intr_frame *f) {
+	const struct syscall_desc *d;
+	uint64_t a[6];
+	uint64_t nr = f->R.rax;
+
 	#ifdef VM
+	/* 시스템 콜 중 유저 스택에서 page fault 가 나면 이 값으로 스택 확장 여부를 판단 */
     thread_current()->rsp_stack = f->rsp;
 	#endif
-	/* 유저 스택에 저장되어 있는 시스템 콜 넘버를 이용해 시스템 콜 핸들러 구현 */
-	int sys_num = f->R.rax;
-	// check_address(sys_num);  /* 스택 포인터가 유저 영역인지 확인 */
-	// printf("===========syscall_handler 안========%d=======\n", sys_num);
-
-	switch (sys_num){
-		case SYS_HALT:
-			halt();
-			break;
-		case SYS_EXIT:
-			exit(f->R.rdi);
-			break;
-		case SYS_CREATE:
-			f->R.rax = create(f->R.rdi, f->R.rsi);
-			break;
-		case SYS_REMOVE:
-			f->R.rax = remove(f->R.rdi);
-			break;
-		case SYS_WRITE:
-			check_valid_buffer(f->R.rsi, f->R.rdx, f->rsp, 0);
-			f->R.rax = write(f->R.rdi, f->R.rsi, f->R.rdx);
-			break;
-		case SYS_WAIT:
-			f->R.rax = wait(f->R.rdi);
-			break;
-		case SYS_FORK:
-			f->R.rax = fork(f->R.rdi, f);
-			break;
-		case SYS_EXEC:
-			if(exec(f->R.rdi) == -1){
-				exit(-1);
-			}
-			break;
-		case SYS_OPEN:
-			f->R.rax = open(f->R.rdi);
-			break;
-		case SYS_CLOSE:
-			close(f->R.rdi);
-			break;
-		case SYS_FILESIZE:
-			f->R.rax = filesize(f->R.rdi);
-			break;
-		case SYS_READ:
-			check_valid_buffer(f->R.rsi, f->R.rdx, f->rsp, 1);
-			f->R.rax = read(f->R.rdi, f->R.rsi, f->R.rdx);
-			break;
-		case SYS_SEEK:
-			seek(f->R.rdi, f->R.rsi);
-			break;
-		case SYS_TELL:
-			f->R.rax = tell(f->R.rdi);
-			break;
-		case SYS_MMAP:
-			f->R.rax = mmap(f->R.rdi, f->R.rsi, f->R.rdx, f->R.r10, f->R.r8);
-			break;
-		case SYS_MUNMAP:
-			munmap(f->R.rdi);
-			break;
-		case SYS_ISDIR:
-			f->R.rax = isdir(f->R.rdi);
+
+	/* 알 수 없는 시스템 콜 번호는 -1 을 반환 */
+	if (nr >= SYSCALL_CNT || syscall_table[nr].func == NULL) {
+		f->R.rax = -1;
+		return;
+	}
+	d = &syscall_table[nr];
+
+	a[0] = f->R.rdi;
+	a[1] = f->R.rsi;
+	a[2] = f->R.rdx;
+	a[3] = f->R.r10;
+	a[4] = f->R.r8;
+	a[5] = f->R.r9;
+	if (d->frame)
+		a[d->arity] = (uint64_t) f;
+	if (!copy_in_args(d, a))
+		exit(-1);
+
+	/* ring worker 와 fd table, file 위치를 나눠 쓰므로 fd 를 다루는 동안 잠근다.
+	   핸들러가 도중에 exit() 하면 process_exit() 에서 풀린다 */
+	if (d->fdt)
+		lock_acquire(&thread_current()->fd_lock);
+	switch (d->ret) {
+		case RET_VOID:
+			((syscall_void_func *) d->func) (a[0], a[1], a[2], a[3], a[4], a[5]);
 			break;
-		case SYS_CHDIR:
-			check_address(f->R.rdi);
-			f->R.rax = chdir(f->R.rdi);
+		case RET_INT:
+			f->R.rax = (int64_t) ((syscall_int_func *) d->func) (a[0], a[1],
+					a[2], a[3], a[4], a[5]);
 			break;
-		case SYS_MKDIR:
-			check_address(f->R.rdi);
-			f->R.rax = mkdir(f->R.rdi);
+		case RET_UINT:
+			f->R.rax = ((syscall_uint_func *) d->func) (a[0], a[1], a[2], a[3],
+					a[4], a[5]);
 			break;
-		case SYS_READDIR:
-			f->R.rax = readdir(f->R.rdi, f->R.rsi);
+		case RET_BOOL:
+			f->R.rax = ((syscall_bool_func *) d->func) (a[0], a[1], a[2], a[3],
+					a[4], a[5]);
 			break;
-		case SYS_INUMBER:
-			f->R.rax = inumber(f->R.rdi);
+		case RET_PTR:
+			f->R.rax = ((syscall_ptr_func *) d->func) (a[0], a[1], a[2], a[3],
+					a[4], a[5]);
 			break;
-		default:
-			// exit(-1);
-			// break;
-			thread_exit();
 	}
+	if (d->fdt)
+		lock_release(&thread_current()->fd_lock);
+	free_args(d, a, d->arity);
 }
 
 
@@ -227,52 +315,44 @@ wait (tid_t pid) {
 
 bool
 create (const char *file, unsigned initial_size) {
-	if (file)
-        return filesys_create(file,initial_size); // ASSERT, dir_add (name!=NULL)
-    else
-        exit(-1);
-	/*
-	lock_acquire(&filesys_lock);
-	bool succ = filesys_create(file, initial_size);
-	lock_release(&filesys_lock);
+	bool succ;
 
+	lock_acquire(&filesys_meta_lock);
+	succ = filesys_create(file,initial_size); // ASSERT, dir_add (name!=NULL)
+	lock_release(&filesys_meta_lock);
 	return succ;
-	*/
 }
 
 bool
 remove (const char *file) {
-	check_address(file);
 	/* 파일 이름에 해당하는 파일을 제거 */
 	/* 파일 제거 성공 시 true 반환, 실패 시 false 반환 */
 	// return filesys_remove(file);
 	bool result = false;
-	lock_acquire(&filesys_lock);
+	lock_acquire(&filesys_meta_lock);
 	result = filesys_remove(file);
-	lock_release(&filesys_lock);
+	lock_release(&filesys_meta_lock);
 
 	return result;
 }
 
 
-/* 자식 프로세스를 생성하고 프로그램을 실행시키는 시스템 콜 */
-int
+/* 자식 프로세스를 생성하고 프로그램을 실행시키는 시스템 콜.
+   성공하면 리턴하지 않고, 실패하면 프로세스를 종료.
+   리턴하지 않으므로 FILE 은 syscall_handler() 가 아니라 여기서 복사한다 */
+void
 exec (const char *file) {
-	check_address(file);
-	char *fn_copy = palloc_get_page(PAL_ZERO);
+	char *fn_copy = copy_in_string(file);
 	if ((fn_copy) == NULL){
 		exit(-1);
 	}	
-	int size = strlen(file) +1 ; // 마지막 null값이라 +1
-	strlcpy(fn_copy, file, size);
 	/* process_exec() 함수를 호출하여 자식 프로세스 생성 */ 
-	if (process_exec(fn_copy) == -1){			/* 프로그램 적재 실패 시 -1 리턴 */
-		return -1;
+	if (process_exec(fn_copy) == -1){			/* 프로그램 적재 실패 시 종료 */
+		exit(-1);
 	}
 
-	/* 프로그램 적재 성공 시 자식 프로세스의 pid 리턴 */
+	/* 프로그램 적재 성공 시 리턴하지 않음 */
 	NOT_REACHED();
-	return 0;
 }
 
  /* 파일을 현재 프로세스의 fdt에 추가 */
@@ -307,16 +387,11 @@ add_file_to_fdt(struct file *file){
 int
 open (const char *file) {
 /* 성공 시 fd를 생성하고 반환, 실패 시 -1 반환 */
-	check_address(file);
-	if (file == NULL) {
-		return -1;
-	}
-	lock_acquire(&filesys_lock);
-
+	lock_acquire(&filesys_meta_lock);
 	struct file *open_file = filesys_open (file);
+	lock_release(&filesys_meta_lock);
 	
 	if(open_file == NULL){
-		lock_release(&filesys_lock);
 		return -1;
 	}
 	
@@ -324,30 +399,90 @@ open (const char *file) {
 	if (fd == -1){ // fd table 가득 찼다면
 		file_close(open_file);
 	}
-	lock_release(&filesys_lock);
 	return fd;
 }
 
+/* FILE 에서 SIZE 바이트를 한 페이지씩 커널 버퍼로 읽어 유저 버퍼 UBUF 로 복사.
+   POS 가 NULL 이면 파일의 현재 위치부터 읽고 위치를 전진, 아니면 *POS 부터 읽고
+   위치는 그대로.  읽은 바이트 수 반환, 유저 버퍼가 잘못됐으면 프로세스 종료 */
+static int
+read_to_user (struct file *file, uint8_t *ubuf, unsigned size, const off_t *pos) {
+	uint8_t *kbuf = palloc_get_page(0);
+	int read_size;
+
+	if (kbuf == NULL)
+		return -1;
+	for (read_size = 0; read_size < (int) size; ) {
+		int chunk = size - read_size < PGSIZE ? size - read_size : PGSIZE;
+		int n = pos == NULL ? file_read(file, kbuf, chunk)	// 실제 읽은 사이즈
+			: file_read_at(file, kbuf, chunk, *pos + read_size);
+
+		if (n > 0 && !copy_to_user(ubuf + read_size, kbuf, n)) {
+			palloc_free_page(kbuf);
+			exit(-1);
+		}
+		read_size += n;
+		if (n < chunk)
+			break;
+	}
+	palloc_free_page(kbuf);
+	return read_size;
+}
+
+/* 유저 버퍼 UBUF 의 SIZE 바이트를 한 페이지씩 커널 버퍼로 복사한 뒤 FD 에 쓴다.
+   FD 가 1 이면 콘솔로, 아니면 FILE 에 쓰고 POS 는 read_to_user() 와 같다.
+   쓴 바이트 수 반환, 유저 버퍼가 잘못됐으면 프로세스 종료 */
+static int
+write_from_user (int fd, struct file *file, const uint8_t *ubuf, unsigned size,
+		const off_t *pos) {
+	uint8_t *kbuf = palloc_get_page(0);
+	int write_result;
+
+	if (kbuf == NULL)
+		return -1;
+	/* 한 페이지씩 나눠 출력해도 다른 프로세스의 출력과 섞이지 않도록
+	   콘솔 lock 을 끝까지 쥐고 있는다 */
+	if (fd == 1)
+		console_acquire();
+	for (write_result = 0; write_result < (int) size; ) {
+		int chunk = size - write_result < PGSIZE ? size - write_result : PGSIZE;
+		int written;
+
+		if (!copy_from_user(kbuf, ubuf + write_result, chunk)) {
+			if (fd == 1)
+				console_release();
+			palloc_free_page(kbuf);
+			exit(-1);
+		}
+		if (fd == 1) {	// stdout(표준 출력) - 모니터
+			putbuf((const char *) kbuf, chunk);
+			written = chunk;
+		} else if (pos == NULL) {
+			written = file_write(file, kbuf, chunk);
+		} else {
+			written = file_write_at(file, kbuf, chunk, *pos + write_result);
+		}
+		write_result += written;
+		if (written < chunk)
+			break;
+	}
+	if (fd == 1)
+		console_release();
+	palloc_free_page(kbuf);
+	return write_result;
+}
+
 int
 write (int fd, const void *buffer, unsigned size) {
-	check_address(buffer);
-	int write_result;
 	struct file *file = fd_to_file(fd);
+
 	if(file == NULL){
 		return -1;
 	}
-
-	if (fd == 1) {	// stdout(표준 출력) - 모니터
-		putbuf(buffer, size);
-		write_result = size;
-	}else if(fd == 0){ // stdin
-		write_result = 0;
-	}else{ 
-		lock_acquire(&filesys_lock);
-		write_result = file_write(file, buffer, size);
-		lock_release(&filesys_lock);
+	if(fd == 0){ // stdin
+		return 0;
 	}
-	return write_result;
+	return write_from_user(fd, file, buffer, size, NULL);
 }
 
 /* 현재 프로세스의 복제본으로 자식 프로세스를 생성 */
@@ -399,9 +534,6 @@ filesize (int fd) {
 
 int
 read (int fd, void *buffer, unsigned size) {
-	// 버퍼의 처음 시작~ 끝 주소 check
-	check_address(buffer);
-	// check_address(buffer+size-1); // -1은 null 전까지만 유효하면 되서 
 	struct file *file = fd_to_file(fd);
 	uint8_t *buf = buffer;
 	int read_size;
@@ -412,22 +544,68 @@ read (int fd, void *buffer, unsigned size) {
 	// 정상인데 0 일 때, 키보드면 input_get
 	if(fd == 0){
 		char keyboard;
-		for(read_size =0; read_size < size; read_size ++){
+		for(read_size =0; read_size < (int) size; read_size ++){
 			keyboard = input_getc();
-			*buf ++ = keyboard;
+			if (!copy_to_user(buf++, &keyboard, 1))
+				exit(-1);
 			if(keyboard == '\0'){ // null 전까지 저장
 				break;
 			}
 		} 
+		return read_size;
 	}else if(fd == 1){ // stdout
 		return -1;
-	}else{
-	// 정상일 때 file_read
-		lock_acquire(&filesys_lock);
-		read_size = file_read(file, buffer, size);	// 실제 읽은 사이즈 return
-		lock_release(&filesys_lock);
 	}
-	return read_size;
+	// 정상일 때 file_read
+	return read_to_user(file, buffer, size, NULL);
+}
+
+/* 파일의 OFFSET 위치에서 읽는 read().  파일의 현재 위치는 바꾸지 않는다 */
+int
+pread (int fd, void *buffer, unsigned size, off_t offset) {
+	struct file *file = fd_to_file(fd);
+
+	if (file == NULL || fd < 2 || offset < 0)
+		return -1;
+	return read_to_user(file, buffer, size, &offset);
+}
+
+/* 파일의 OFFSET 위치에 쓰는 write().  파일의 현재 위치는 바꾸지 않는다 */
+int
+pwrite (int fd, const void *buffer, unsigned size, off_t offset) {
+	struct file *file = fd_to_file(fd);
+
+	if (file == NULL || fd < 2 || offset < 0)
+		return -1;
+	return write_from_user(fd, file, buffer, size, &offset);
+}
+
+/* FD_IN 의 OFF_IN 위치에서 FD_OUT 의 OFF_OUT 위치로 SIZE 바이트를 커널 안에서
+   복사.  오프셋이 -1 이면 그 파일의 현재 위치를 쓰고 복사한 만큼 전진.
+   같은 파일 안에서 겹치는 범위는 -1 */
+int
+copy_file_range (int fd_in, off_t off_in, int fd_out, off_t off_out,
+		unsigned size) {
+	struct file *in = fd_to_file(fd_in);
+	struct file *out = fd_to_file(fd_out);
+	off_t in_ofs, out_ofs, copied;
+
+	if (in == NULL || out == NULL || fd_in < 2 || fd_out < 2
+			|| off_in < -1 || off_out < -1 || size > INT_MAX)
+		return -1;
+	in_ofs = off_in == -1 ? file_tell(in) : off_in;
+	out_ofs = off_out == -1 ? file_tell(out) : off_out;
+	if (file_get_inode(in) == file_get_inode(out)
+			&& in_ofs < (int64_t) out_ofs + size
+			&& out_ofs < (int64_t) in_ofs + size)
+		return -1;
+
+	copied = file_copy_range(in, in_ofs, out, out_ofs, size);
+	if (off_in == -1)
+		file_seek(in, in_ofs + copied);
+	if (off_out == -1)
+		file_seek(out, out_ofs + copied);
+	return copied;
 }
 
 /* 다음 읽거나 쓸 file_pos 옮겨주기 */
@@ -519,7 +697,7 @@ bool chdir (char *path_name) {
 	if (strlen(path) == 0)
 		return NULL;
 
-
+	lock_acquire(&filesys_meta_lock);
 	if (path[0] == '/')
 		dir = dir_open_root();
 	else
@@ -552,6 +730,7 @@ bool chdir (char *path_name) {
 	}
 	dir_close(curr->cur_dir);
 	curr->cur_dir = dir;
+	lock_release(&filesys_meta_lock);
 	free(path);
 
 	/* dir 정보 반환 */
@@ -561,6 +740,7 @@ fail:
 	dir_close(dir);
 	if (inode)
 		inode_close(inode);
+	lock_release(&filesys_meta_lock);
 	free(path);
 
 	return false;
@@ -568,7 +748,12 @@ fail:
 
 
 bool mkdir (char *dir){
-	return filesys_create_dir(dir);
+	bool succ;
+
+	lock_acquire(&filesys_meta_lock);
+	succ = filesys_create_dir(dir);
+	lock_release(&filesys_meta_lock);
+	return succ;
 }
 
 bool readdir (int fd, char *name){
@@ -578,10 +763,15 @@ bool readdir (int fd, char *name){
 	// struct dir *dir = dir_open(file->inode);
 	struct dir *dir = file;
 
+	char kname[NAME_MAX + 1];
 	bool result = false;
-	result = dir_readdir(dir, name);
+	lock_acquire(&filesys_meta_lock);
+	result = dir_readdir(dir, kname);
+	lock_release(&filesys_meta_lock);
 		
 	// dir_close(dir);
+	if (result && !copy_to_user(name, kname, strlen(kname) + 1))
+		exit(-1);
 	return result;
 }
 
@@ -590,4 +780,215 @@ int inumber(int fd){
 	if(file == NULL)
 		return false;
 	return inode_get_inumber(file->inode);
-}
\ No newline at end of file
+}
+/* Copies the scheduler statistics of up to MAX threads into BUF
+   and returns the total number of live threads, so that a caller
+   whose buffer was too small can tell and retry.  At most one
+   page worth of entries is returned per call. */
+int
+sched_stats (struct sched_stats *buf, int max) {
+	struct sched_stats *kbuf;
+	int cnt;
+
+	if (max < 0)
+		return -1;
+	if (max > (int) (PGSIZE / sizeof *kbuf))
+		max = PGSIZE / sizeof *kbuf;
+
+	/* Take the snapshot into kernel memory first: faulting in
+	   BUF must not happen with interrupts off. */
+	kbuf = palloc_get_page(0);
+	if (kbuf == NULL)
+		return -1;
+	cnt = thread_get_stats(kbuf, max);
+	if (!copy_to_user(buf, kbuf, (cnt < max ? cnt : max) * sizeof *buf)) {
+		palloc_free_page(kbuf);
+		exit(-1);
+	}
+	palloc_free_page(kbuf);
+	return cnt;
+}
+
+/* Size of the bounce buffer for readv() and writev(), in pages.
+   A vector totalling no more than this reaches the file system
+   in a single file_read() or file_write(). */
+#define IOV_BOUNCE_PAGES 16
+
+/* Copies the IOVCNT segments at user address UIOV into a new
+   kernel array, stores their total length in *TOTAL and returns
+   the array, which the caller must free().  Kills the process if
+   UIOV cannot be read.  Returns NULL if memory runs out or if the
+   total does not fit in an int. */
+static struct iovec *
+copy_in_iovec (const struct iovec *uiov, int iovcnt, size_t *total) {
+	struct iovec *iov = malloc(iovcnt * sizeof *iov);
+	int i;
+
+	if (iov == NULL)
+		return NULL;
+	if (!copy_from_user(iov, uiov, iovcnt * sizeof *iov)) {
+		free(iov);
+		exit(-1);
+	}
+	*total = 0;
+	for (i = 0; i < iovcnt; i++) {
+		if (iov[i].iov_len > INT_MAX - *total) {
+			free(iov);
+			return NULL;
+		}
+		*total += iov[i].iov_len;
+	}
+	return iov;
+}
+
+/* Allocates a bounce buffer for TOTAL bytes, at most
+   IOV_BOUNCE_PAGES pages, and stores its size in pages in *PAGES.
+   Falls back to a single page if that many are not free. */
+static uint8_t *
+alloc_bounce (size_t total, size_t *pages) {
+	size_t cnt = DIV_ROUND_UP(total, PGSIZE);
+	uint8_t *buf;
+
+	if (cnt > IOV_BOUNCE_PAGES)
+		cnt = IOV_BOUNCE_PAGES;
+	buf = palloc_get_multiple(0, cnt);
+	if (buf == NULL && cnt > 1) {
+		cnt = 1;
+		buf = palloc_get_page(0);
+	}
+	*pages = cnt;
+	return buf;
+}
+
+/* Copies N bytes between KBUF and the user segments of IOV,
+   starting at offset *OFS in segment *SEG, and advances *SEG and
+   *OFS past them.  Copies to user memory if TO_USER, from it
+   otherwise.  Returns false if a segment is not accessible. */
+static bool
+iov_copy (const struct iovec *iov, int *seg, size_t *ofs, uint8_t *kbuf,
+		size_t n, bool to_user) {
+	while (n > 0) {
+		uint8_t *ubuf = (uint8_t *) iov[*seg].iov_base + *ofs;
+		size_t len = iov[*seg].iov_len - *ofs;
+
+		/* An empty segment's base is never looked at. */
+		if (len > n)
+			len = n;
+		if (len > 0 && !(to_user ? copy_to_user(ubuf, kbuf, len)
+					: copy_from_user(kbuf, ubuf, len)))
+			return false;
+		kbuf += len;
+		n -= len;
+		*ofs += len;
+		if (*ofs == iov[*seg].iov_len) {
+			(*seg)++;
+			*ofs = 0;
+		}
+	}
+	return true;
+}
+
+/* read() 의 scatter 버전.  세그먼트를 모두 합친 길이만큼 한 번에 읽은 뒤
+   유저 세그먼트들로 나눠 복사한다 */
+int
+readv (int fd, const struct iovec *uiov, int iovcnt) {
+	struct file *file = fd_to_file(fd);
+	struct iovec *iov;
+	uint8_t *kbuf;
+	size_t total, pages, done = 0, ofs = 0;
+	int seg = 0;
+
+	if (file == NULL || fd == 1 || iovcnt < 0 || iovcnt > IOV_MAX)
+		return -1;
+	if (iovcnt == 0)
+		return 0;
+	iov = copy_in_iovec(uiov, iovcnt, &total);
+	if (iov == NULL)
+		return -1;
+
+	if (fd == 0) {	// 키보드는 세그먼트마다 read()
+		for (seg = 0; seg < iovcnt; seg++) {
+			int n = read(fd, iov[seg].iov_base, iov[seg].iov_len);
+			done += n;
+			if ((size_t) n < iov[seg].iov_len)
+				break;
+		}
+		free(iov);
+		return done;
+	}
+
+	kbuf = total > 0 ? alloc_bounce(total, &pages) : NULL;
+	if (total > 0 && kbuf == NULL) {
+		free(iov);
+		return -1;
+	}
+	while (done < total) {
+		size_t want = total - done < pages * PGSIZE ? total - done : pages * PGSIZE;
+		size_t n = file_read(file, kbuf, want);
+
+		if (!iov_copy(iov, &seg, &ofs, kbuf, n, true)) {
+			palloc_free_multiple(kbuf, pages);
+			free(iov);
+			exit(-1);
+		}
+		done += n;
+		if (n < want)
+			break;
+	}
+	if (kbuf != NULL)
+		palloc_free_multiple(kbuf, pages);
+	free(iov);
+	return done;
+}
+
+/* write() 의 gather 버전.  유저 세그먼트들을 커널 버퍼 하나로 모아서
+   한 번에 쓴다 */
+int
+writev (int fd, const struct iovec *uiov, int iovcnt) {
+	struct file *file = fd_to_file(fd);
+	struct iovec *iov;
+	uint8_t *kbuf;
+	size_t total, pages, done = 0, ofs = 0;
+	int seg = 0;
+
+	if (file == NULL || iovcnt < 0 || iovcnt > IOV_MAX)
+		return -1;
+	if (fd == 0 || iovcnt == 0)	// stdin
+		return 0;
+	iov = copy_in_iovec(uiov, iovcnt, &total);
+	if (iov == NULL)
+		return -1;
+
+	kbuf = total > 0 ? alloc_bounce(total, &pages) : NULL;
+	if (total > 0 && kbuf == NULL) {
+		free(iov);
+		return -1;
+	}
+	if (fd == 1)	// write() 와 같이 출력 전체를 콘솔 lock 안에서
+		console_acquire();
+	while (done < total) {
+		size_t want = total - done < pages * PGSIZE ? total - done : pages * PGSIZE;
+		size_t n;
+
+		if (!iov_copy(iov, &seg, &ofs, kbuf, want, false)) {
+			if (fd == 1)
+				console_release();
+			palloc_free_multiple(kbuf, pages);
+			free(iov);
+			exit(-1);
+		}
+		if (fd == 1) {	// stdout
+			putbuf((const char *) kbuf, want);
+			n = want;
+		} else {
+			n = file_write(file, kbuf, want);
+		}
+		done += n;
+		if (n < want)
+			break;
+	}
+	if (kbuf != NULL)
+		palloc_free_multiple(kbuf, pages);
+	free(iov);
+	return done;
+}
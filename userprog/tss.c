@@ -3,7 +3,7 @@
 #include <stddef.h>
 #include "userprog/gdt.h"
 #include "threads/thread.h"
-#include "threads/palloc.h"
+#include "threads/smp.h"
 #include "threads/vaddr.h"
 #include "intrinsic.h"
 
@@ -43,32 +43,38 @@
  *      not in use, so we can always use that.  Thus, when the
  *      scheduler switches threads, it also changes the TSS's
  *      stack pointer to point to the new thread's kernel stack.
- *      (The call is in schedule in thread.c.) */
+ *      (The call is in schedule in thread.c.)
+ *
+ *  Each CPU runs its own thread, so each CPU has its own TSS,
+ *  found through its struct cpu. */
 
-/* Kernel TSS. */
-struct task_state *tss;
+/* Kernel TSS of each CPU.  Static rather than allocated, since an
+ * application processor sets its up before it may sleep on the
+ * page allocator's lock. */
+static struct task_state tss_area[CPU_MAX];
 
-/* Initializes the kernel TSS. */
+/* Initializes the running CPU's kernel TSS. */
 void
 tss_init (void) {
 	/* Our TSS is never used in a call gate or task gate, so only a
 	 * few fields of it are ever referenced, and those are the only
 	 * ones we initialize. */
-	tss = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+	cpu_current ()->tss = &tss_area[cpu_id ()];
 	tss_update (thread_current ());
 }
 
-/* Returns the kernel TSS. */
+/* Returns the running CPU's kernel TSS. */
 struct task_state *
 tss_get (void) {
+	struct task_state *tss = cpu_current ()->tss;
+
 	ASSERT (tss != NULL);
 	return tss;
 }
 
-/* Sets the ring 0 stack pointer in the TSS to point to the end
- * of the thread stack. */
+/* Sets the ring 0 stack pointer in the running CPU's TSS to
+ * point to the end of the thread stack. */
 void
 tss_update (struct thread *next) {
-	ASSERT (tss != NULL);
-	tss->rsp0 = (uint64_t) next + PGSIZE;
+	tss_get ()->rsp0 = (uint64_t) next + PGSIZE;
 }
@@ -0,0 +1,75 @@
+#include "userprog/uaccess.h"
+#include <stdint.h>
+#include "threads/interrupt.h"
+#include "threads/vaddr.h"
+
+/* An exception table entry, emitted by copy-user.S. */
+struct ex_entry {
+	uintptr_t insn;             /* Instruction that may fault. */
+	uintptr_t fixup;            /* Where to resume if it does. */
+};
+
+/* Bounds of the exception table, from kernel.lds.S. */
+extern const struct ex_entry __start_ex_table[], __stop_ex_table[];
+
+size_t copy_user (void *dst, const void *src, size_t n);
+long strncpy_user (char *dst, const char *src, size_t size);
+
+/* Returns true if the SIZE bytes at UADDR lie wholly in user
+   space. */
+static bool
+user_range_ok (const void *uaddr, size_t size) {
+	return is_user_vaddr (uaddr)
+		&& size <= (uintptr_t) KERN_BASE - (uintptr_t) uaddr;
+}
+
+/* Copies SIZE bytes from user address USRC to kernel buffer DST.
+   Returns false if any of USRC is not readable by the process. */
+bool
+copy_from_user (void *dst, const void *usrc, size_t size) {
+	return user_range_ok (usrc, size) && copy_user (dst, usrc, size) == 0;
+}
+
+/* Copies SIZE bytes from kernel buffer SRC to user address UDST.
+   Returns false if any of UDST is not writable by the process. */
+bool
+copy_to_user (void *udst, const void *src, size_t size) {
+	return user_range_ok (udst, size) && copy_user (udst, src, size) == 0;
+}
+
+/* Copies the null-terminated string at user address USRC into
+   the SIZE bytes at DST.  Returns the length of the string, or
+   SIZE if it is too long to fit, in which case DST is not
+   null-terminated.  Returns -1 if the string is not readable by
+   the process. */
+long
+strncpy_from_user (char *dst, const char *usrc, size_t size) {
+	size_t room;
+	long len;
+
+	if (!is_user_vaddr (usrc))
+		return -1;
+	room = (uintptr_t) KERN_BASE - (uintptr_t) usrc;
+	if (room >= size)
+		return strncpy_user (dst, usrc, size);
+
+	/* The string must end before kernel space. */
+	len = strncpy_user (dst, usrc, room);
+	return len < 0 || (size_t) len == room ? -1 : len;
+}
+
+/* Called by the page fault handler for a fault in kernel mode
+   that it could not resolve.  If F's instruction is one of the
+   user copies, redirects F to the copy's fixup and returns true.
+   Otherwise the fault is a kernel bug and false is returned. */
+bool
+uaccess_fixup (struct intr_frame *f) {
+	const struct ex_entry *e;
+
+	for (e = __start_ex_table; e < __stop_ex_table; e++)
+		if (e->insn == f->rip) {
+			f->rip = e->fixup;
+			return true;
+		}
+	return false;
+}
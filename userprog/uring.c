@@ -0,0 +1,358 @@
+#include "userprog/uring.h"
+#include <console.h>
+#include <debug.h>
+#include <round.h>
+#include <stdio.h>
+#include <string.h>
+#include <uring.h>
+#include "devices/timer.h"
+#include "filesys/file.h"
+#include "filesys/filesys.h"
+#include "threads/malloc.h"
+#include "threads/mmu.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/process.h"
+#ifdef VM
+#include "vm/vm.h"
+#endif
+
+/* Pages in a struct uring. */
+#define URING_PAGES DIV_ROUND_UP (sizeof (struct uring), PGSIZE)
+
+/* Ticks a polling worker keeps looking at an empty submission
+   ring before it goes to sleep. */
+#define URING_IDLE_TICKS 10
+
+/* Kernel side of a process's ring. */
+struct uring_ctx {
+	struct uring *ring;             /* Kernel mapping of the shared pages. */
+	void *uaddr;                    /* Where the process sees them. */
+	struct thread *owner;           /* Process whose files are used. */
+	struct lock lock;               /* Held while requests run. */
+
+	/* Polling mode only. */
+	tid_t worker;                   /* Worker thread, or TID_ERROR. */
+	struct condition sq_ready;      /* Wakes a sleeping worker. */
+	struct condition completed;     /* Broadcast after each batch. */
+	bool stopping;                  /* Tells the worker to exit. */
+};
+
+/* In userprog/syscall.c. */
+extern struct lock filesys_meta_lock;
+
+static thread_func worker;
+
+/* Returns the number of requests waiting in RING. */
+static uint32_t
+sq_pending (const struct uring *ring) {
+	uint32_t n = ring->sq_tail - ring->sq_head;
+
+	/* Treat a corrupt tail as an empty ring. */
+	return n <= URING_SQ_ENTRIES ? n : 0;
+}
+
+/* Returns the number of completions the process has not taken
+   from RING yet. */
+static uint32_t
+cq_ready (const struct uring *ring) {
+	return ring->cq_tail - ring->cq_head;
+}
+
+/* Returns the file that OWNER has open as FD, or a null pointer.
+   The console descriptors have no file.  OWNER's fd_lock must be
+   held. */
+static struct file *
+owner_file (struct thread *owner, int fd) {
+	if (fd < 2 || fd >= MAX_FD_NUM)
+		return NULL;
+	return owner->fd_table[fd];
+}
+
+/* Runs the open request SQE for CTX's owner, as open() would. */
+static int
+run_open (struct uring_ctx *ctx, const struct uring_sqe *sqe) {
+	struct thread *owner = ctx->owner;
+	const char *uname = (const char *) ctx->ring->buf + sqe->buf;
+	size_t len = strnlen (uname, URING_BUF_SIZE - sqe->buf);
+	struct file *file;
+	char *name;
+	int fd = -1;
+
+	/* Copy the name: the process may change it under us. */
+	if (len == URING_BUF_SIZE - sqe->buf)
+		return -1;
+	name = malloc (len + 1);
+	if (name == NULL)
+		return -1;
+	memcpy (name, uname, len);
+	name[len] = '\0';
+
+	/* Relative names are resolved against OWNER's working directory,
+	   not the worker's, which chdir() does not follow.  chdir()
+	   replaces it under filesys_meta_lock. */
+	lock_acquire (&filesys_meta_lock);
+	file = filesys_open_at (owner->cur_dir, name);
+	lock_release (&filesys_meta_lock);
+	if (file != NULL) {
+		while (owner->fdidx < MAX_FD_NUM && owner->fd_table[owner->fdidx])
+			owner->fdidx++;
+		if (owner->fdidx < MAX_FD_NUM) {
+			owner->fd_table[owner->fdidx] = file;
+			fd = owner->fdidx;
+		} else
+			file_close (file);
+	}
+	free (name);
+	return fd;
+}
+
+/* Runs request SQE for CTX's owner and returns its result. */
+static int
+run_request (struct uring_ctx *ctx, const struct uring_sqe *sqe) {
+	uint8_t *data = ctx->ring->buf + sqe->buf;
+	struct file *file;
+
+	if (sqe->buf > URING_BUF_SIZE || sqe->len > URING_BUF_SIZE - sqe->buf)
+		return -1;
+
+	switch (sqe->opcode) {
+		case URING_OP_NOP:
+			return 0;
+		case URING_OP_READ:
+			file = owner_file (ctx->owner, sqe->fd);
+			if (file == NULL)
+				return -1;
+			return sqe->off < 0 ? file_read (file, data, sqe->len)
+				: file_read_at (file, data, sqe->len, sqe->off);
+		case URING_OP_WRITE:
+			if (sqe->fd == 1) {
+				console_acquire ();
+				putbuf ((const char *) data, sqe->len);
+				console_release ();
+				return sqe->len;
+			}
+			file = owner_file (ctx->owner, sqe->fd);
+			if (file == NULL)
+				return -1;
+			return sqe->off < 0 ? file_write (file, data, sqe->len)
+				: file_write_at (file, data, sqe->len, sqe->off);
+		case URING_OP_OPEN:
+			return run_open (ctx, sqe);
+		case URING_OP_CLOSE:
+			/* As close() does. */
+			if (owner_file (ctx->owner, sqe->fd) == NULL)
+				return -1;
+			ctx->owner->fd_table[sqe->fd] = NULL;
+			return 0;
+		default:
+			return -1;
+	}
+}
+
+/* Runs up to MAX of the requests waiting in CTX's ring, stopping
+   early if the completion ring fills up.  Returns the number
+   run.  CTX's lock must be held. */
+static unsigned
+run_requests (struct uring_ctx *ctx, unsigned max) {
+	struct uring *ring = ctx->ring;
+	uint32_t pending = sq_pending (ring);
+	unsigned cnt;
+
+	ASSERT (lock_held_by_current_thread (&ctx->lock));
+
+	for (cnt = 0; cnt < max && cnt < pending; cnt++) {
+		struct uring_sqe sqe;
+		struct uring_cqe *cqe;
+
+		if (cq_ready (ring) >= URING_CQ_ENTRIES)
+			break;
+
+		/* Take a private copy, so that the process cannot change
+		   the request after it has been checked. */
+		sqe = ring->sq[ring->sq_head % URING_SQ_ENTRIES];
+		barrier ();
+		ring->sq_head++;
+
+		/* OWNER's system calls on descriptors run under the same
+		   lock, so a request sees the table and file positions
+		   between two of them, never in the middle of one. */
+		cqe = &ring->cq[ring->cq_tail % URING_CQ_ENTRIES];
+		cqe->user_data = sqe.user_data;
+		lock_acquire (&ctx->owner->fd_lock);
+		cqe->res = run_request (ctx, &sqe);
+		lock_release (&ctx->owner->fd_lock);
+		cqe->pad = 0;
+		barrier ();
+		ring->cq_tail++;
+	}
+	return cnt;
+}
+
+/* Maps a new ring at page-aligned user address ADDR in the
+   current process and returns ADDR, or a null pointer if the
+   process already has a ring, any page of the range is already
+   in use, or memory runs out.  With URING_SETUP_SQPOLL, also
+   starts a worker thread that polls the ring. */
+void *
+uring_setup (void *addr, unsigned flags) {
+	struct thread *cur = thread_current ();
+	struct uring_ctx *ctx;
+	uint8_t *kpage;
+	size_t i;
+
+	if (cur->uring != NULL || addr == NULL || pg_ofs (addr) != 0
+			|| (flags & ~URING_SETUP_SQPOLL) != 0)
+		return NULL;
+	for (i = 0; i < URING_PAGES; i++) {
+		uint8_t *upage = (uint8_t *) addr + i * PGSIZE;
+
+		if (!is_user_vaddr (upage) || pml4_get_page (cur->pml4, upage) != NULL)
+			return NULL;
+#ifdef VM
+		/* The ring has no SPT entry, so keep it out of the SPT and
+		   of the region the stack may grow into. */
+		if (spt_find_page (&cur->spt, upage) != NULL
+				|| upage >= (uint8_t *) USER_STACK - STACK_GROWTH_MAX)
+			return NULL;
+#endif
+	}
+
+	ctx = malloc (sizeof *ctx);
+	if (ctx == NULL)
+		return NULL;
+	kpage = palloc_get_multiple (PAL_USER | PAL_ZERO, URING_PAGES);
+	if (kpage == NULL) {
+		free (ctx);
+		return NULL;
+	}
+	for (i = 0; i < URING_PAGES; i++)
+		if (!pml4_set_page (cur->pml4, (uint8_t *) addr + i * PGSIZE,
+					kpage + i * PGSIZE, true)) {
+			while (i-- > 0)
+				pml4_clear_page (cur->pml4, (uint8_t *) addr + i * PGSIZE);
+			palloc_free_multiple (kpage, URING_PAGES);
+			free (ctx);
+			return NULL;
+		}
+
+	ctx->ring = (struct uring *) kpage;
+	ctx->uaddr = addr;
+	ctx->owner = cur;
+	lock_init (&ctx->lock);
+	ctx->worker = TID_ERROR;
+	cond_init (&ctx->sq_ready);
+	cond_init (&ctx->completed);
+	ctx->stopping = false;
+	cur->uring = ctx;
+
+	if (flags & URING_SETUP_SQPOLL) {
+		char name[16];
+
+		snprintf (name, sizeof name, "uring/%d", cur->tid);
+		ctx->worker = thread_create (name, PRI_DEFAULT, worker, ctx);
+		if (ctx->worker == TID_ERROR) {
+			uring_destroy ();
+			return NULL;
+		}
+	}
+	return addr;
+}
+
+/* Runs up to TO_SUBMIT queued requests of the current process's
+   ring and returns the number run, or -1 if the process has no
+   ring.  Every request run has completed on return.
+
+   In polling mode, wakes the worker if it sleeps, then waits
+   until at least MIN_COMPLETE completions are ready or the
+   submission ring is empty, and returns 0. */
+int
+uring_enter (unsigned to_submit, unsigned min_complete) {
+	struct uring_ctx *ctx = thread_current ()->uring;
+	int cnt = 0;
+
+	if (ctx == NULL)
+		return -1;
+	if (min_complete > URING_CQ_ENTRIES)
+		min_complete = URING_CQ_ENTRIES;
+
+	lock_acquire (&ctx->lock);
+	if (ctx->worker == TID_ERROR)
+		cnt = run_requests (ctx, to_submit);
+	else {
+		/* The worker runs batches with the lock held, so here it
+		   is between batches or asleep. */
+		while (cq_ready (ctx->ring) < min_complete
+				&& sq_pending (ctx->ring) > 0) {
+			if (ctx->ring->flags & URING_NEED_WAKEUP)
+				cond_signal (&ctx->sq_ready, &ctx->lock);
+			cond_wait (&ctx->completed, &ctx->lock);
+		}
+		if (ctx->ring->flags & URING_NEED_WAKEUP)
+			cond_signal (&ctx->sq_ready, &ctx->lock);
+	}
+	lock_release (&ctx->lock);
+	return cnt;
+}
+
+/* Stops the current process's polling worker, if any, and unmaps
+   and frees its ring.  Called when the process exits or execs. */
+void
+uring_destroy (void) {
+	struct thread *cur = thread_current ();
+	struct uring_ctx *ctx = cur->uring;
+	size_t i;
+
+	if (ctx == NULL)
+		return;
+
+	if (ctx->worker != TID_ERROR) {
+		lock_acquire (&ctx->lock);
+		ctx->stopping = true;
+		cond_signal (&ctx->sq_ready, &ctx->lock);
+		lock_release (&ctx->lock);
+		process_wait (ctx->worker);
+	}
+
+	if (cur->pml4 != NULL)
+		for (i = 0; i < URING_PAGES; i++)
+			pml4_clear_page (cur->pml4, (uint8_t *) ctx->uaddr + i * PGSIZE);
+	palloc_free_multiple (ctx->ring, URING_PAGES);
+	cur->uring = NULL;
+	free (ctx);
+}
+
+/* Polling worker.  Runs requests as they appear in CTX_'s ring,
+   and sleeps once the ring has been empty for URING_IDLE_TICKS. */
+static void
+worker (void *ctx_) {
+	struct uring_ctx *ctx = ctx_;
+	struct uring *ring = ctx->ring;
+	int64_t idle_since = timer_ticks ();
+
+	lock_acquire (&ctx->lock);
+	while (!ctx->stopping) {
+		if (run_requests (ctx, URING_SQ_ENTRIES) > 0) {
+			cond_broadcast (&ctx->completed, &ctx->lock);
+			idle_since = timer_ticks ();
+		} else if (timer_elapsed (idle_since) >= URING_IDLE_TICKS) {
+			/* Set the flag before looking at the ring one last
+			   time, so that a request queued meanwhile is either
+			   seen here or followed by a uring_enter(). */
+			ring->flags |= URING_NEED_WAKEUP;
+			barrier ();
+			if (sq_pending (ring) == 0 && !ctx->stopping)
+				cond_wait (&ctx->sq_ready, &ctx->lock);
+			ring->flags &= ~URING_NEED_WAKEUP;
+			idle_since = timer_ticks ();
+		} else {
+			/* Poll again once everyone else has had a turn. */
+			lock_release (&ctx->lock);
+			thread_yield ();
+			lock_acquire (&ctx->lock);
+		}
+	}
+	lock_release (&ctx->lock);
+}
@@ -91,9 +91,18 @@ do_mmap(void *addr, size_t length, int writable,
 		struct file *file, off_t offset)
 {
 	void *ori_addr = addr;
-	struct file *mfile = file_reopen(file);
+	struct thread *cur = thread_current();
 	size_t read_bytes = length > file_length(file) ? file_length(file) : length;
 	size_t zero_bytes = PGSIZE - read_bytes % PGSIZE;
+	size_t ofs;
+
+	/* uring 링처럼 SPT 없이 커널이 직접 매핑한 페이지 위에는 매핑하지 않는다 */
+	for (ofs = 0; ofs < read_bytes + zero_bytes; ofs += PGSIZE)
+		if (spt_find_page(&cur->spt, addr + ofs) != NULL
+			|| pml4_get_page(cur->pml4, addr + ofs) != NULL)
+			return NULL;
+
+	struct file *mfile = file_reopen(file);
 
 	while (read_bytes > 0 || zero_bytes > 0)
 	{
@@ -101,14 +101,12 @@ struct page *
 spt_find_page(struct supplemental_page_table *spt UNUSED, void *va UNUSED)
 { 
 	// 에러전 마지막 va: 0x400000
-	struct page *page = NULL;
-	page = (struct page *)malloc(sizeof(struct page));
+	/* 검색 키로만 쓰이므로 malloc 대신 스택에 둔다 */
+	struct page key;
 	struct hash_elem *e;
 
-	page->va = pg_round_down(va);
-	e = hash_find(&spt->hash_tb, &page->h_elem);
-
-	free(page);
+	key.va = pg_round_down(va);
+	e = hash_find(&spt->hash_tb, &key.h_elem);
 
 	return e != NULL ? hash_entry(e, struct page, h_elem) : NULL;
 }
@@ -281,10 +279,8 @@ bool vm_try_handle_fault(struct intr_frame *f UNUSED, void *addr UNUSED,
 		return false;
 	}
 
-	void *rsp_stack;
-
-	if (user)
-		rsp_stack = is_kernel_vaddr(f->rsp) ? thread_current()->rsp_stack : f->rsp;
+	/* 커널 모드 fault (유저 메모리 복사 중) 이면 시스템 콜 진입 시 저장한 유저 rsp 사용 */
+	void *rsp_stack = user ? (void *) f->rsp : thread_current()->rsp_stack;
 	
 	page = spt_find_page(spt, addr);
 	
@@ -415,33 +411,14 @@ bool supplemental_page_table_copy(struct supplemental_page_table *dst,
       break;
     case VM_ANON:
       // printf("VMANON\n");
-      vm_alloc_page(tmp->operations->type, tmp->va, tmp->writable);
-      cpy = spt_find_page(dst, tmp->va);
-
-
-      if (cpy == NULL)
-      {
-        return false;
-      }
-
-      cpy->copy_writable = tmp->writable;
-      struct frame *cpy_frame = malloc(sizeof(struct frame));
-      cpy->frame = cpy_frame;
-      cpy_frame->page = cpy;
-      cpy_frame->kva = tmp->frame->kva;
-
-      struct thread *t = thread_current();
-
-      list_push_back(&frame_table, &cpy_frame->frame_elem);
-
-
-      if (pml4_set_page(t->pml4, cpy->va, cpy_frame->kva, 0) == false)
-      {
-        // printf("child set page flase \n");
+      /* 프레임을 부모와 공유하면 부모 쪽 PTE는 여전히 쓰기 가능하다.
+         SMP에서는 자식이 처음 쓰기 전에 부모가 (스택 등) 공유 페이지를
+         고쳐 버리므로, 부모가 fork()에서 기다리는 동안 바로 복사한다. */
+      if (!vm_alloc_page(tmp->operations->type, tmp->va, tmp->writable)
+          || !vm_claim_page(tmp->va))
         return false;
-      }
-      swap_in(cpy, cpy_frame->kva);
-     
+      cpy = spt_find_page(dst, tmp->va);
+      memcpy(cpy->frame->kva, tmp->frame->kva, PGSIZE);
       break;
     case VM_FILE:
       break;